@@ -2,34 +2,42 @@
 // License: GPLv3
 #include "circle.h"
 #include "spiral_scene.h"
-#include <QPainter>
 #include <QtMath>
 
 namespace SpiralFun {
 
 namespace {
 constexpr int CIRCLE_PEN_WIDTH = 1;
-constexpr int SELECT_PEN_WIDTH = 8;
 }
 
-Circle::Circle(SpiralScene* parent) :
-    QQuickPaintedItem(parent),
+Circle::Circle(SpiralScene* parent, unsigned index) :
+    QObject(parent),
     mScene(parent),
-    mPenWidth(CIRCLE_PEN_WIDTH)
+    mIndex(index)
 {
-    setEnabled(true);
-    setAntialiasing(true);
+}
+
+const SpiralEngine& Circle::engine() const
+{
+    Q_ASSERT(mScene);
+    return mScene->getEngine();
+}
+
+SpiralEngine& Circle::engine()
+{
+    Q_ASSERT(mScene);
+    return mScene->getEngine();
 }
 
 Circle::Direction Circle::getDirection() const
 {
-    return mSpeed < 0 ? COUNTER_CLOCKWISE : CLOCKWISE;
+    return getSpeed() < 0 ? COUNTER_CLOCKWISE : CLOCKWISE;
 }
 
 Circle* Circle::setCenter(const QPointF& center)
 {
-    moveTo(center);
-    mDrawPos = center;
+    engine().setCenter(mIndex, center);
+    updatePosition();
     return this;
 }
 
@@ -41,15 +49,11 @@ Circle* Circle::setRadius(qreal radius)
 
 Circle* Circle::setDiameter(int diameter)
 {
-    if (mDiameter != diameter)
+    if (getDiameter() != diameter)
     {
-        const int oldDiameter = mDiameter;
-        mDiameter = diameter;
-
-        // Make the bounding box large too show a selected circle.
-        const qreal d = diameter + SELECT_PEN_WIDTH;
-        setSize({d, d});
-        moveTo(mCenter);
+        const int oldDiameter = getDiameter();
+        engine().setDiameter(mIndex, diameter);
+        syncView();
         emit diameterChanged(oldDiameter);
     }
 
@@ -58,11 +62,11 @@ Circle* Circle::setDiameter(int diameter)
 
 Circle* Circle::setColor(const QColor& color)
 {
-    if (mColor != color)
+    if (getColor() != color)
     {
-        mColor = color;
+        engine().setColor(mIndex, color);
         emit colorChanged();
-        update();
+        mScene->updateCircleOutlines();
     }
 
     return this;
@@ -73,9 +77,9 @@ Circle* Circle::setDraw(int draw)
     Q_ASSERT(draw >= 0);
     Q_ASSERT(draw <= MAX_DRAW);
 
-    if (draw != mDraw)
+    if (draw != getDraw())
     {
-        mDraw = draw;
+        engine().setDraw(mIndex, draw);
         emit drawChanged();
     }
 
@@ -84,9 +88,10 @@ Circle* Circle::setDraw(int draw)
 
 Circle* Circle::setSpeed(int speed)
 {
-    const bool rotChanged = (std::abs(speed) != std::abs(mSpeed));
-    const bool dirChanged = (speed < 0 && mSpeed >= 0) || (speed >=0 && mSpeed < 0);
-    mSpeed = speed;
+    const int oldSpeed = getSpeed();
+    const bool rotChanged = (std::abs(speed) != std::abs(oldSpeed));
+    const bool dirChanged = (speed < 0 && oldSpeed >= 0) || (speed >=0 && oldSpeed < 0);
+    engine().setSpeed(mIndex, speed);
 
     if (rotChanged)
         emit rotationsChanged();
@@ -98,12 +103,12 @@ Circle* Circle::setSpeed(int speed)
 
 Circle* Circle::setRotations(int rotations)
 {
-    return setSpeed(rotations * (mSpeed < 0 ? -1 : 1));
+    return setSpeed(rotations * (getSpeed() < 0 ? -1 : 1));
 }
 
 Circle* Circle::setDirection(Direction direction)
 {
-    const int rotations = std::abs(mSpeed);
+    const int rotations = getRotations();
     switch (direction)
     {
     case CLOCKWISE:
@@ -116,94 +121,51 @@ Circle* Circle::setDirection(Direction direction)
     return this;
 }
 
-void Circle::setEnabled(bool enabled)
-{
-    setAcceptedMouseButtons(enabled ? Qt::LeftButton : Qt::NoButton);
-}
-
 void Circle::setFocus(bool focus)
 {
-    mPenWidth = focus ? SELECT_PEN_WIDTH : CIRCLE_PEN_WIDTH;
-    update();
-}
-
-void Circle::rotate(const QPointF& rotationCenter, qreal angle, bool clockwise)
-{
-    const QLineF line(rotationCenter, mCenter);
-    const qreal d = line.length();
-    const qreal oldAngle = qDegreesToRadians(line.angle());
-    const qreal newAngle = oldAngle + angle * (clockwise ? -1 : 1);
-    const qreal x = qCos(newAngle) * d + rotationCenter.x();
-    const qreal y = -qSin(newAngle) * d + rotationCenter.y();
-
-    const QPointF newCenter(x, y);
-    moveTo(newCenter);
-
-    if (mDraw)
-        drawTo(newCenter);
+    mFocus = focus;
+    mScene->updateCircleOutlines();
 }
 
-void Circle::moveTo(const QPointF& center)
+qreal Circle::getPenWidth() const
 {
-    mCenter = center;
-
-    if (isVisible())
-    {
-        setX(mCenter.x() - getRadius() - SELECT_PEN_WIDTH / 2.0);
-        setY(mCenter.y() - getRadius() - SELECT_PEN_WIDTH / 2.0);
-    }
+    return mFocus ? SELECT_PEN_WIDTH : CIRCLE_PEN_WIDTH;
 }
 
-void Circle::drawTo(const QPointF& center, bool force)
+void Circle::syncView()
 {
-    const QLineF line(mDrawPos, center);
-    if (line.length() >= mMinDrawLength || force)
-    {
-        Q_ASSERT(*mSceneLine);
-        mSceneLine->addPoint(center);
-        mDrawPos = center;
-        mDrawnLength += line.length();
-    }
+    updatePosition();
 }
 
-void Circle::forceDrawToCenter()
+// The scene redraws all outlines at most once per frame.
+void Circle::updatePosition()
 {
-    drawTo(mCenter, true);
+    if (mVisible)
+        mScene->updateCircleOutlines();
 }
 
 void Circle::removeFromScene()
 {
-    setVisible(false);
+    mVisible = false;
+    mScene->updateCircleOutlines();
 }
 
 void Circle::addToScene()
 {
-    setVisible(true);
-    moveTo(mCenter);
-}
-
-void Circle::paint(QPainter* painter)
-{
-    QPen pen(mColor, mPenWidth, Qt::SolidLine, Qt::RoundCap);
-    painter->setPen(pen);
-    const qreal coord = SELECT_PEN_WIDTH / 2.0;
-    const QRectF r(coord, coord, qreal(mDiameter), qreal(mDiameter));
-    painter->drawEllipse(r);
+    mVisible = true;
+    updatePosition();
 }
 
 void Circle::preparePlay()
 {
     mSceneLine = {};
-    mDrawnLength = 0;
-
-    if (mDraw)
-        mSceneLine = mScene->addLine(this, mColor, mDraw, mCenter);
-}
+    engine().setPenPoints(mIndex, nullptr);
 
-void Circle::mousePressEvent(QMouseEvent *event)
-{
-    mScene->selectCircle(this);
-    event->accept();
+    if (getDraw())
+    {
+        mSceneLine = mScene->addLine(this, getColor(), getDraw(), getCenter());
+        engine().setPenPoints(mIndex, &mSceneLine->mLinePoints);
+    }
 }
 
 }
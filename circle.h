@@ -2,13 +2,17 @@
 // License: GPLv3
 #pragma once
 #include "scoped_line.h"
-#include <QQuickPaintedItem>
+#include "spiral_engine.h"
+#include <qqml.h>
+#include <QObject>
 
 namespace SpiralFun {
 
 class SpiralScene;
 
-class Circle : public QQuickPaintedItem
+// View on a circle in the SpiralEngine. The outlines of all circles are drawn
+// by the scene.
+class Circle : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(int diameter READ getDiameter WRITE setDiameter NOTIFY diameterChanged)
@@ -19,22 +23,24 @@ class Circle : public QQuickPaintedItem
     QML_ELEMENT
 
 public:
-    static constexpr int MAX_DRAW = 7;
+    static constexpr int MAX_DRAW = SpiralEngine::MAX_DRAW;
+    static constexpr int SELECT_PEN_WIDTH = 8;
 
-    explicit Circle(SpiralScene* parent = nullptr);
+    explicit Circle(SpiralScene* parent = nullptr, unsigned index = 0);
 
     enum Direction { CLOCKWISE = 0, COUNTER_CLOCKWISE = 1 };
     Q_ENUM(Direction)
 
-    const QPointF& getCenter() const { return mCenter; }
-    qreal getRadius() const { return mDiameter / 2.0; }
-    int getDiameter() const { return mDiameter; }
-    int getSpeed() const { return mSpeed; }
+    unsigned getIndex() const { return mIndex; }
+    const QPointF& getCenter() const { return engine().getCenter(mIndex); }
+    qreal getRadius() const { return engine().getRadius(mIndex); }
+    int getDiameter() const { return engine().getDiameter(mIndex); }
+    int getSpeed() const { return engine().getSpeed(mIndex); }
     int getRotations() const { return std::abs(getSpeed()); }
     Direction getDirection() const;
-    const QColor& getColor() const { return mColor; }
-    int getDraw() const { return mDraw; }
-    QRectF getBoundingRect() const { return QRectF(-getRadius(), -getRadius(), mDiameter, mDiameter); };
+    const QColor& getColor() const { return engine().getColor(mIndex); }
+    int getDraw() const { return engine().getDraw(mIndex); }
+    QRectF getBoundingRect() const { return QRectF(-getRadius(), -getRadius(), getDiameter(), getDiameter()); };
     Circle* setColor(const QColor& color);
     Circle* setDraw(int draw);
     Circle* setSpeed(int speed);
@@ -43,17 +49,17 @@ public:
     Circle* setCenter(const QPointF& center);
     Circle* setRadius(qreal radius);
     Circle* setDiameter(int diameter);
-    void setEnabled(bool enabled);
+    bool hasFocus() const { return mFocus; }
     void setFocus(bool focus);
-    void rotate(const QPointF& rotationCenter, qreal angle, bool clockwise = true);
+    bool isVisible() const { return mVisible; }
+    qreal getPenWidth() const;
     void removeFromScene();
     void addToScene();
-    void forceDrawToCenter();
     void preparePlay();
-    qreal getDrawnLength() const { return mDrawnLength; }
-    void setDrawnLength(qreal drawnLength) { mDrawnLength = drawnLength; }
 
-    void paint(QPainter* painter) override;
+    // Synchronize the outline with the circle data in the engine.
+    void syncView();
+    void updatePosition();
 
 signals:
     void diameterChanged(int oldDiameter);
@@ -62,23 +68,14 @@ signals:
     void directionChanged();
     void colorChanged();
 
-protected:
-    void mousePressEvent(QMouseEvent *event) override;
-
 private:
-    void moveTo(const QPointF& center);
-    void drawTo(const QPointF& center, bool force = false);
+    const SpiralEngine& engine() const;
+    SpiralEngine& engine();
 
     SpiralScene* mScene;
-    QPointF mCenter;
-    QPointF mDrawPos;
-    int mDiameter = 1;
-    QColor mColor = Qt::white;
-    int mDraw = 0;
-    int mSpeed = 0;
-    const qreal mMinDrawLength = 2.0;
-    qreal mDrawnLength = 0.0;
-    int mPenWidth;
+    unsigned mIndex;
+    bool mFocus = false;
+    bool mVisible = true;
     ScopedLine mSceneLine;
 };
 
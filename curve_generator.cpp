@@ -0,0 +1,140 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "curve_generator.h"
+#include <QDebug>
+#include <QtMath>
+
+namespace SpiralFun {
+
+namespace {
+// More chunks than threads to balance the load, as the sampling density
+// differs along the curve.
+constexpr int CHUNKS_PER_THREAD = 4;
+}
+
+CurveGenerator::CurveGenerator(SpiralEngine& engine, QObject* parent) :
+    QObject(parent),
+    mEngine(engine)
+{
+}
+
+CurveGenerator::~CurveGenerator()
+{
+    cancel();
+}
+
+void CurveGenerator::start(qreal fromAngle, qreal toAngle, qreal stepAngle)
+{
+    Q_ASSERT(mChunks.empty());
+    mToAngle = toAngle;
+
+    // Only the first sector of a symmetric curve needs to be calculated.
+    mSymmetry = mEngine.getSymmetry();
+    mSectorRotation = mEngine.getSectorRotation();
+    const qreal sectorEndAngle = fromAngle + (toAngle - fromAngle) / mSymmetry;
+    qDebug() << "Symmetry:" << mSymmetry << "sector rotation:" << qRadiansToDegrees(mSectorRotation);
+
+    const int chunksPerCircle = std::max(1, mThreadPool.maxThreadCount() * CHUNKS_PER_THREAD);
+    const qreal chunkAngle = (sectorEndAngle - fromAngle) / chunksPerCircle;
+
+    for (unsigned i = 1; i < mEngine.size(); ++i)
+    {
+        if (!mEngine.getDraw(i))
+            continue;
+
+        for (int n = 0; n < chunksPerCircle; ++n)
+        {
+            const qreal chunkTo = (n == chunksPerCircle - 1) ? sectorEndAngle : fromAngle + (n + 1) * chunkAngle;
+            mChunks.push_back({ i, fromAngle + n * chunkAngle, chunkTo, {} });
+        }
+    }
+
+    qDebug() << "Curve chunks:" << mChunks.size() << "threads:" << mThreadPool.maxThreadCount();
+
+    if (mChunks.empty())
+    {
+        mEngine.moveCircles(toAngle);
+        emit done();
+        return;
+    }
+
+    for (unsigned c = 0; c < mChunks.size(); ++c)
+    {
+        mThreadPool.start([this, c, stepAngle]{
+            if (mCanceled)
+                return;
+
+            Chunk& chunk = mChunks[c];
+            chunk.mSampleCount = mEngine.sampleRange(chunk.mIndex, chunk.mFromAngle, chunk.mToAngle, stepAngle, chunk.mPoints);
+            QMetaObject::invokeMethod(this, [this, c]{ chunkReady(c); }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void CurveGenerator::cancel()
+{
+    mCanceled = true;
+    mThreadPool.clear();
+    mThreadPool.waitForDone();
+}
+
+void CurveGenerator::chunkReady(unsigned chunkIndex)
+{
+    if (mCanceled)
+        return;
+
+    mChunks[chunkIndex].mReady = true;
+
+    if (chunkIndex != mNextChunkToDraw)
+        return;
+
+    while (mNextChunkToDraw < mChunks.size() && mChunks[mNextChunkToDraw].mReady)
+    {
+        Chunk& chunk = mChunks[mNextChunkToDraw];
+        mEngine.drawSamples(chunk.mIndex, chunk.mPoints, chunk.mSampleCount);
+
+        if (mSymmetry == 1)
+            chunk.mPoints = {};
+
+        ++mNextChunkToDraw;
+    }
+
+    emit progress(qreal(mNextChunkToDraw) / mChunks.size());
+
+    if (mNextChunkToDraw == mChunks.size())
+    {
+        drawRotatedSectors();
+        mEngine.moveCircles(mToAngle);
+        emit done();
+    }
+}
+
+void CurveGenerator::drawRotatedSectors()
+{
+    const QPointF& center = mEngine.getCenter(0);
+    SpiralEngine::PointList rotated;
+
+    for (unsigned sector = 1; sector < mSymmetry; ++sector)
+    {
+        const qreal rotation = sector * mSectorRotation;
+        const qreal c = std::cos(rotation);
+        const qreal s = std::sin(rotation);
+
+        // Chunks are ordered per circle, so the sectors of a circle are drawn
+        // in order.
+        for (const Chunk& chunk : mChunks)
+        {
+            rotated.resize(chunk.mPoints.size());
+
+            for (unsigned i = 0; i < chunk.mPoints.size(); ++i)
+            {
+                const QPointF p = chunk.mPoints[i] - center;
+                rotated[i] = center + QPointF(p.x() * c + p.y() * s, p.y() * c - p.x() * s);
+            }
+
+            mEngine.drawSamples(chunk.mIndex, rotated, 0);
+        }
+    }
+}
+
+}
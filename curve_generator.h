@@ -0,0 +1,59 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "spiral_engine.h"
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+
+namespace SpiralFun {
+
+// Generates the complete curves of the drawing circles on a thread pool. The
+// angle range is split in chunks that are sampled in parallel. Finished chunks
+// are drawn in order on the thread that owns the generator.
+//
+// For curves with k-fold rotational symmetry only the first 1/k of the range
+// is sampled. The other sectors are drawn by rotating these samples.
+class CurveGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CurveGenerator(SpiralEngine& engine, QObject* parent = nullptr);
+    ~CurveGenerator();
+
+    // SpiralEngine::preparePlay must have been called.
+    void start(qreal fromAngle, qreal toAngle, qreal stepAngle);
+    void cancel();
+    unsigned getChunkCount() const { return mChunks.size(); }
+    unsigned getSymmetry() const { return mSymmetry; }
+
+signals:
+    void progress(qreal fraction);
+    void done();
+
+private:
+    struct Chunk
+    {
+        unsigned mIndex;
+        qreal mFromAngle;
+        qreal mToAngle;
+        SpiralEngine::PointList mPoints;
+        uint64_t mSampleCount = 0;
+        bool mReady = false;
+    };
+
+    void chunkReady(unsigned chunkIndex);
+    void drawRotatedSectors();
+
+    SpiralEngine& mEngine;
+    QThreadPool mThreadPool;
+    std::vector<Chunk> mChunks;
+    unsigned mNextChunkToDraw = 0;
+    qreal mToAngle = 0.0;
+    unsigned mSymmetry = 1;
+    qreal mSectorRotation = 0.0;
+    std::atomic_bool mCanceled = false;
+};
+
+}
@@ -0,0 +1,315 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "curve_sampler.h"
+#include "sincos_approx.h"
+#include <cmath>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace SpiralFun {
+
+CurveSampler::Kernel CurveSampler::detectKernel()
+{
+    static const Kernel kernel = []{
+#ifdef SPIRALFUN_AVX2
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return Kernel::AVX2;
+#endif
+#if defined(__aarch64__)
+        return Kernel::NEON;
+#else
+        return Kernel::SCALAR;
+#endif
+    }();
+
+    return kernel;
+}
+
+const char* CurveSampler::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::SCALAR:
+        return "scalar";
+    case Kernel::AVX2:
+        return "avx2";
+    case Kernel::NEON:
+        return "neon";
+    }
+
+    Q_ASSERT(false);
+    return "unknown";
+}
+
+void CurveSampler::init(const EpicycleEvaluator& evaluator, unsigned index)
+{
+    Q_ASSERT(index < evaluator.size());
+    mArms.mOriginX = evaluator.getOrigin().x();
+    mArms.mOriginY = evaluator.getOrigin().y();
+    mArms.mLengths.clear();
+    mArms.mStartAngles.clear();
+    mArms.mSpeeds.clear();
+
+    for (unsigned i = 0; i < index; ++i)
+    {
+        const auto& arm = evaluator.getArms()[i];
+
+        // Arms that do not move are added to the origin.
+        if (arm.mSpeed == 0)
+        {
+            mArms.mOriginX += std::cos(arm.mStartAngle) * arm.mLength;
+            mArms.mOriginY -= std::sin(arm.mStartAngle) * arm.mLength;
+            continue;
+        }
+
+        mArms.mLengths.push_back(arm.mLength);
+        mArms.mStartAngles.push_back(arm.mStartAngle);
+        mArms.mSpeeds.push_back(arm.mSpeed);
+    }
+
+    mJerkBound = 0.0;
+    mSpeedBound = 0.0;
+
+    for (unsigned k = 0; k < mArms.mLengths.size(); ++k)
+    {
+        mJerkBound += mArms.mLengths[k] * std::pow(std::abs(mArms.mSpeeds[k]), 3);
+        mSpeedBound += mArms.mLengths[k] * std::abs(mArms.mSpeeds[k]);
+    }
+}
+
+void CurveSampler::sample(qreal startAngle, qreal stepAngle, unsigned count, double* xs, double* ys) const
+{
+    switch (mKernel)
+    {
+    case Kernel::AVX2:
+#ifdef SPIRALFUN_AVX2
+    {
+        const unsigned done = sampleCurveAvx2(mArms.mOriginX, mArms.mOriginY, mArms.mLengths.data(),
+                                              mArms.mStartAngles.data(), mArms.mSpeeds.data(),
+                                              mArms.mLengths.size(), startAngle, stepAngle, count, xs, ys);
+
+        if (done < count)
+            sampleCurveScalar(mArms, startAngle + done * stepAngle, stepAngle, count - done, xs + done, ys + done);
+
+        return;
+    }
+#else
+        break;
+#endif
+    case Kernel::NEON:
+#if defined(__aarch64__)
+        sampleCurveNeon(mArms, startAngle, stepAngle, count, xs, ys);
+        return;
+#else
+        break;
+#endif
+    case Kernel::SCALAR:
+        break;
+    }
+
+    sampleCurveScalar(mArms, startAngle, stepAngle, count, xs, ys);
+}
+
+void CurveSampler::sample(qreal startAngle, qreal stepAngle, unsigned count, std::vector<QPointF>& points) const
+{
+    thread_local std::vector<double> xs;
+    thread_local std::vector<double> ys;
+    xs.resize(count);
+    ys.resize(count);
+    sample(startAngle, stepAngle, count, xs.data(), ys.data());
+    points.resize(count);
+
+    for (unsigned i = 0; i < count; ++i)
+        points[i] = QPointF(xs[i], ys[i]);
+}
+
+qreal CurveSampler::getAcceleration(qreal angle) const
+{
+    double x = 0.0;
+    double y = 0.0;
+
+    for (unsigned k = 0; k < mArms.mLengths.size(); ++k)
+    {
+        double s, c;
+        const double speed = mArms.mSpeeds[k];
+        SincosApprox::sincos(mArms.mStartAngles[k] - angle * speed, s, c);
+        x -= mArms.mLengths[k] * speed * speed * c;
+        y += mArms.mLengths[k] * speed * speed * s;
+    }
+
+    return std::sqrt(x * x + y * y);
+}
+
+std::vector<std::pair<qreal, qreal>> CurveSampler::getAngleRangesInRect(const QRectF& rect, qreal fromAngle, qreal toAngle,
+                                                                        qreal resolution) const
+{
+    std::vector<std::pair<qreal, qreal>> ranges;
+    const qreal minStep = resolution / mSpeedBound;
+    qreal angle = fromAngle;
+    qreal prevAngle = fromAngle;
+    qreal rangeStart = fromAngle;
+    bool inside = false;
+
+    // Ranges that touch are merged.
+    auto addRange = [&ranges](qreal from, qreal to){
+        if (!ranges.empty() && ranges.back().second >= from)
+            ranges.back().second = to;
+        else
+            ranges.emplace_back(from, to);
+    };
+
+    while (true)
+    {
+        double x, y;
+        sample(angle, 0.0, 1, &x, &y);
+
+        // Positive outside the rect, negative inside.
+        const qreal dx = std::max(rect.left() - x, x - rect.right());
+        const qreal dy = std::max(rect.top() - y, y - rect.bottom());
+        const bool isInside = dx <= 0.0 && dy <= 0.0;
+
+        // The pen entered or left the rect somewhere after the previous position.
+        if (isInside && !inside)
+        {
+            rangeStart = prevAngle;
+            inside = true;
+        }
+        else if (!isInside && inside)
+        {
+            addRange(rangeStart, angle);
+            inside = false;
+        }
+
+        if (angle >= toAngle || mSpeedBound <= 0.0)
+            break;
+
+        // The pen cannot cross the border of the rect within this step.
+        const qreal distance = isInside ? std::min(-dx, -dy) : std::hypot(std::max(dx, 0.0), std::max(dy, 0.0));
+        prevAngle = angle;
+        angle = std::min(toAngle, angle + std::max(distance / mSpeedBound, minStep));
+    }
+
+    if (inside)
+        addRange(rangeStart, toAngle);
+
+    return ranges;
+}
+
+void sampleCurveScalar(const CurveSampler::Arms& arms, qreal startAngle, qreal stepAngle, unsigned count, double* xs, double* ys)
+{
+    const unsigned armCount = arms.mLengths.size();
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const double angle = startAngle + i * stepAngle;
+        double x = arms.mOriginX;
+        double y = arms.mOriginY;
+
+        for (unsigned k = 0; k < armCount; ++k)
+        {
+            double s, c;
+            SincosApprox::sincos(arms.mStartAngles[k] - angle * arms.mSpeeds[k], s, c);
+            x += arms.mLengths[k] * c;
+            y -= arms.mLengths[k] * s;
+        }
+
+        xs[i] = x;
+        ys[i] = y;
+    }
+}
+
+#if defined(__aarch64__)
+namespace {
+
+struct SinCos
+{
+    float64x2_t mSin;
+    float64x2_t mCos;
+};
+
+// Same calculation as SincosApprox::sincos on 2 angles.
+inline SinCos sincos(float64x2_t x)
+{
+    using namespace SincosApprox;
+    const float64x2_t q = vrndnq_f64(vmulq_n_f64(x, TWO_OVER_PI));
+    float64x2_t r = vfmsq_f64(x, q, vdupq_n_f64(PIO2_HI));
+    r = vfmsq_f64(r, q, vdupq_n_f64(PIO2_LO));
+    const float64x2_t z = vmulq_f64(r, r);
+
+    float64x2_t ps = vdupq_n_f64(SIN_COEF[0]);
+    float64x2_t pc = vdupq_n_f64(COS_COEF[0]);
+
+    for (int i = 1; i < 6; ++i)
+    {
+        ps = vfmaq_f64(vdupq_n_f64(SIN_COEF[i]), ps, z);
+        pc = vfmaq_f64(vdupq_n_f64(COS_COEF[i]), pc, z);
+    }
+
+    const float64x2_t sr = vfmaq_f64(r, vmulq_f64(r, z), ps);
+    const float64x2_t cr = vfmaq_f64(vfmsq_f64(vdupq_n_f64(1.0), vdupq_n_f64(0.5), z), vmulq_f64(z, z), pc);
+
+    // quadrant = q mod 4
+    const float64x2_t quarter = vrndmq_f64(vmulq_n_f64(q, 0.25));
+    const float64x2_t quadrant = vfmsq_f64(q, quarter, vdupq_n_f64(4.0));
+    const uint64x2_t q1 = vceqq_f64(quadrant, vdupq_n_f64(1.0));
+    const uint64x2_t q2 = vceqq_f64(quadrant, vdupq_n_f64(2.0));
+    const uint64x2_t q3 = vceqq_f64(quadrant, vdupq_n_f64(3.0));
+    const uint64x2_t swap = vorrq_u64(q1, q3);
+    const uint64x2_t sinNeg = vorrq_u64(q2, q3);
+    const uint64x2_t cosNeg = vorrq_u64(q1, q2);
+
+    const float64x2_t s = vbslq_f64(swap, cr, sr);
+    const float64x2_t c = vbslq_f64(swap, sr, cr);
+    return { vbslq_f64(sinNeg, vnegq_f64(s), s), vbslq_f64(cosNeg, vnegq_f64(c), c) };
+}
+
+}
+
+void sampleCurveNeon(const CurveSampler::Arms& arms, qreal startAngle, qreal stepAngle, unsigned count, double* xs, double* ys)
+{
+    const unsigned armCount = arms.mLengths.size();
+    const double laneValues[] = { 0.0, 1.0, 2.0, 3.0 };
+    const float64x2_t lanesLow = vld1q_f64(laneValues);
+    const float64x2_t lanesHigh = vld1q_f64(laneValues + 2);
+    const float64x2_t start = vdupq_n_f64(startAngle);
+    const float64x2_t step = vdupq_n_f64(stepAngle);
+    unsigned i = 0;
+
+    // 4 angles per iteration in 2 registers to hide the latency of the FMA chains.
+    for (; i + 4 <= count; i += 4)
+    {
+        const float64x2_t n = vdupq_n_f64(double(i));
+        const float64x2_t angleLow = vfmaq_f64(start, vaddq_f64(n, lanesLow), step);
+        const float64x2_t angleHigh = vfmaq_f64(start, vaddq_f64(n, lanesHigh), step);
+        float64x2_t xLow = vdupq_n_f64(arms.mOriginX);
+        float64x2_t yLow = vdupq_n_f64(arms.mOriginY);
+        float64x2_t xHigh = xLow;
+        float64x2_t yHigh = yLow;
+
+        for (unsigned k = 0; k < armCount; ++k)
+        {
+            const float64x2_t speed = vdupq_n_f64(arms.mSpeeds[k]);
+            const float64x2_t armStart = vdupq_n_f64(arms.mStartAngles[k]);
+            const float64x2_t length = vdupq_n_f64(arms.mLengths[k]);
+            const SinCos low = sincos(vfmsq_f64(armStart, angleLow, speed));
+            const SinCos high = sincos(vfmsq_f64(armStart, angleHigh, speed));
+            xLow = vfmaq_f64(xLow, length, low.mCos);
+            yLow = vfmsq_f64(yLow, length, low.mSin);
+            xHigh = vfmaq_f64(xHigh, length, high.mCos);
+            yHigh = vfmsq_f64(yHigh, length, high.mSin);
+        }
+
+        vst1q_f64(xs + i, xLow);
+        vst1q_f64(xs + i + 2, xHigh);
+        vst1q_f64(ys + i, yLow);
+        vst1q_f64(ys + i + 2, yHigh);
+    }
+
+    if (i < count)
+        sampleCurveScalar(arms, startAngle + i * stepAngle, stepAngle, count - i, xs + i, ys + i);
+}
+#endif
+
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "epicycle_evaluator.h"
+#include <QPointF>
+#include <QRectF>
+#include <utility>
+#include <vector>
+
+namespace SpiralFun {
+
+// Calculates the positions of one circle for many angles per call. As the
+// position is a sum of rotating vectors, each angle is calculated independently,
+// such that multiple angles are calculated in parallel in SIMD lanes.
+//
+// Sine and cosine are approximated by polynomials after reduction of the
+// argument to [-pi/4, pi/4] (see sincos_approx.h). The absolute error per
+// sine/cosine is below 2.5e-16 for arguments up to 1.6e6 radians, i.e. the
+// position error is below 2.5e-16 * (sum of the arm lengths), which is far
+// below a pixel.
+class CurveSampler
+{
+public:
+    enum class Kernel { SCALAR, AVX2, NEON };
+
+    // Fastest kernel supported by the CPU.
+    static Kernel detectKernel();
+    static const char* kernelName(Kernel kernel);
+
+    struct Arms
+    {
+        qreal mOriginX = 0.0;
+        qreal mOriginY = 0.0;
+        std::vector<double> mLengths;
+        std::vector<double> mStartAngles;
+        std::vector<double> mSpeeds;
+    };
+
+    void init(const EpicycleEvaluator& evaluator, unsigned index);
+    Kernel getKernel() const { return mKernel; }
+    void setKernel(Kernel kernel) { mKernel = kernel; }
+
+    // Calculate the positions at startAngle + i * stepAngle for i in [0, count).
+    // A sampler may be used from multiple threads at the same time.
+    void sample(qreal startAngle, qreal stepAngle, unsigned count, double* xs, double* ys) const;
+    void sample(qreal startAngle, qreal stepAngle, unsigned count, std::vector<QPointF>& points) const;
+
+    // Size of the second derivative of the position to the angle.
+    qreal getAcceleration(qreal angle) const;
+
+    // Upper bound of the size of the third derivative of the position.
+    qreal getJerkBound() const { return mJerkBound; }
+
+    // Upper bound of the distance moved per radian.
+    qreal getSpeedBound() const { return mSpeedBound; }
+
+    // Angle ranges between fromAngle and toAngle that contain all angles at
+    // which the position is inside rect. Positions are calculated at distances
+    // of at least resolution along the curve, such that positions less than
+    // resolution inside rect may be missed. Far from the border of the rect the
+    // angle is advanced by the distance to the border divided by the speed
+    // bound, such that the cost depends on the length of the curve near rect.
+    std::vector<std::pair<qreal, qreal>> getAngleRangesInRect(const QRectF& rect, qreal fromAngle, qreal toAngle,
+                                                              qreal resolution) const;
+
+private:
+    Arms mArms;
+    qreal mJerkBound = 0.0;
+    qreal mSpeedBound = 0.0;
+    Kernel mKernel = detectKernel();
+};
+
+// Kernels, xs and ys have room for count positions.
+void sampleCurveScalar(const CurveSampler::Arms& arms, qreal startAngle, qreal stepAngle, unsigned count, double* xs, double* ys);
+#ifdef SPIRALFUN_AVX2
+// The AVX2 kernel gets the arms as raw arrays, such that its translation unit,
+// which is compiled with AVX2 enabled, does not instantiate inline functions
+// of shared headers. The linker could otherwise pick those AVX2 copies for the
+// whole program. It calculates the positions of whole groups of 4 and returns
+// how many it calculated.
+unsigned sampleCurveAvx2(double originX, double originY, const double* lengths, const double* startAngles,
+                         const double* speeds, unsigned armCount, double startAngle, double stepAngle,
+                         unsigned count, double* xs, double* ys);
+#endif
+#if defined(__aarch64__)
+void sampleCurveNeon(const CurveSampler::Arms& arms, qreal startAngle, qreal stepAngle, unsigned count, double* xs, double* ys);
+#endif
+
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+//
+// This file is compiled with -mavx2 -mfma. Its kernel is only called when the
+// CPU supports these instructions. It must not call inline functions of shared
+// headers, as their out-of-line copies would be compiled with AVX2 too.
+#include "curve_sampler.h"
+
+#ifdef SPIRALFUN_AVX2
+#include "sincos_approx.h"
+#include <immintrin.h>
+
+namespace SpiralFun {
+
+namespace {
+
+struct SinCos
+{
+    __m256d mSin;
+    __m256d mCos;
+};
+
+// Same calculation as SincosApprox::sincos on 4 angles.
+inline SinCos sincos(__m256d x)
+{
+    using namespace SincosApprox;
+    const __m256d q = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(TWO_OVER_PI)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_HI), x);
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_LO), r);
+    const __m256d z = _mm256_mul_pd(r, r);
+
+    __m256d ps = _mm256_set1_pd(SIN_COEF[0]);
+    __m256d pc = _mm256_set1_pd(COS_COEF[0]);
+
+    for (int i = 1; i < 6; ++i)
+    {
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(SIN_COEF[i]));
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(COS_COEF[i]));
+    }
+
+    const __m256d sr = _mm256_fmadd_pd(_mm256_mul_pd(r, z), ps, r);
+    const __m256d cr = _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc,
+                                       _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+    // quadrant = q mod 4
+    const __m256d quarter = _mm256_floor_pd(_mm256_mul_pd(q, _mm256_set1_pd(0.25)));
+    const __m256d quadrant = _mm256_fnmadd_pd(quarter, _mm256_set1_pd(4.0), q);
+    const __m256d q1 = _mm256_cmp_pd(quadrant, _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+    const __m256d q2 = _mm256_cmp_pd(quadrant, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+    const __m256d q3 = _mm256_cmp_pd(quadrant, _mm256_set1_pd(3.0), _CMP_EQ_OQ);
+    const __m256d swap = _mm256_or_pd(q1, q3);
+    const __m256d sinNeg = _mm256_or_pd(q2, q3);
+    const __m256d cosNeg = _mm256_or_pd(q1, q2);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+
+    const __m256d s = _mm256_blendv_pd(sr, cr, swap);
+    const __m256d c = _mm256_blendv_pd(cr, sr, swap);
+    return { _mm256_xor_pd(s, _mm256_and_pd(sinNeg, signBit)),
+             _mm256_xor_pd(c, _mm256_and_pd(cosNeg, signBit)) };
+}
+
+}
+
+unsigned sampleCurveAvx2(double originX, double originY, const double* lengths, const double* startAngles,
+                         const double* speeds, unsigned armCount, double startAngle, double stepAngle,
+                         unsigned count, double* xs, double* ys)
+{
+    const __m256d lanes = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+    const __m256d start = _mm256_set1_pd(startAngle);
+    const __m256d step = _mm256_set1_pd(stepAngle);
+    unsigned i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d n = _mm256_add_pd(_mm256_set1_pd(double(i)), lanes);
+        const __m256d angle = _mm256_fmadd_pd(n, step, start);
+        __m256d x = _mm256_set1_pd(originX);
+        __m256d y = _mm256_set1_pd(originY);
+
+        for (unsigned k = 0; k < armCount; ++k)
+        {
+            const __m256d a = _mm256_fnmadd_pd(angle, _mm256_set1_pd(speeds[k]),
+                                               _mm256_set1_pd(startAngles[k]));
+            const SinCos sc = sincos(a);
+            const __m256d length = _mm256_set1_pd(lengths[k]);
+            x = _mm256_fmadd_pd(length, sc.mCos, x);
+            y = _mm256_fnmadd_pd(length, sc.mSin, y);
+        }
+
+        _mm256_storeu_pd(xs + i, x);
+        _mm256_storeu_pd(ys + i, y);
+    }
+
+    return i;
+}
+
+}
+
+#endif
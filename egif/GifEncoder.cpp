@@ -21,24 +21,37 @@
         data                                                                    \
     )
 
-// MICHEL: changed to 4 byte RGBA pixels
-static void getColorMap(uint8_t *colorMap, const uint8_t *pixels, int nPixels, int quality) {
-    initnet(pixels, nPixels * 4, quality);
-    learn();
-    unbiasnet();
-    inxbuild();
-    getcolourmap(colorMap);
+// MICHEL: changed to 4 byte RGBA pixels in rows of stride bytes
+static void getColorMap(NeuQuant &neuQuant, uint8_t *colorMap, const uint8_t *pixels, int width, int height, int stride,
+                        int quality) {
+    neuQuant.initnet(pixels, width * height * 4, quality, width * 4, stride);
+    neuQuant.learn();
+    neuQuant.unbiasnet();
+    neuQuant.inxbuild();
+    neuQuant.getcolourmap(colorMap);
 }
 
-// MICHEL: changed to 4 byte RGBA pixels
-static void getRasterBits(uint8_t *rasterBits, const uint8_t *pixels, int nPixels) {
-    const int indexBlack = inxsearch(0, 0, 0);
-
-    for (int i = 0; i < nPixels; ++i) {
-        const int r = pixels[i * 4];
-        const int g = pixels[i * 4 + 1];
-        const int b = pixels[i * 4 + 2];
-        rasterBits[i] = (b == 0 && g == 0 && r == 0) ? indexBlack : inxsearch(b, g, r);
+// MICHEL: the color after the colors of the network
+static constexpr int TRANSPARENT_INDEX = netsize;
+
+// MICHEL: changed to 4 byte RGBA pixels in rows of stride bytes. Pixels with
+// alpha 0 are transparent.
+static void getRasterBits(const NeuQuant &neuQuant, uint8_t *rasterBits, const uint8_t *pixels, int width, int height,
+                          int stride) {
+    const int indexBlack = neuQuant.inxsearch(0, 0, 0);
+
+    for (int y = 0; y < height; ++y, pixels += stride, rasterBits += width) {
+        for (int x = 0; x < width; ++x) {
+            const int r = pixels[x * 4];
+            const int g = pixels[x * 4 + 1];
+            const int b = pixels[x * 4 + 2];
+            const int a = pixels[x * 4 + 3];
+
+            if (a == 0)
+                rasterBits[x] = TRANSPARENT_INDEX;
+            else
+                rasterBits[x] = (b == 0 && g == 0 && r == 0) ? indexBlack : neuQuant.inxsearch(b, g, r);
+        }
     }
 }
 
@@ -132,10 +145,14 @@ bool GifEncoder::open(const std::string &file, int width, int height, int qualit
         return false;
     }
 
+    // MICHEL: the color map and raster are reused for all frames
+    m_colorMap = GifMakeMapObject(256, nullptr);
+    m_rasterBits.reserve(width * height);
+
     return true;
 }
 
-bool GifEncoder::push(const uint8_t *frame, int x, int y, int width, int height, int delay) {
+bool GifEncoder::push(const uint8_t *frame, int x, int y, int width, int height, int stride, int delay) {
     if (m_gifFile == nullptr) {
         return false;
     }
@@ -144,13 +161,15 @@ bool GifEncoder::push(const uint8_t *frame, int x, int y, int width, int height,
         return false;
     }
 
-    auto *colorMap = GifMakeMapObject(256, nullptr);
-    getColorMap((uint8_t *) colorMap->Colors, frame, width * height, m_quality);
+    // MICHEL: the quantizer has no global state
+    NeuQuant neuQuant;
+    auto *colorMap = (ColorMapObject *) m_colorMap;
+    getColorMap(neuQuant, (uint8_t *) colorMap->Colors, frame, width, height, stride, m_quality);
 
-    auto *rasterBits = (GifByteType *) malloc(width * height);
-    getRasterBits((uint8_t *) rasterBits, frame, width * height);
+    m_rasterBits.resize(width * height);
+    getRasterBits(neuQuant, m_rasterBits.data(), frame, width, height, stride);
 
-    if (!encodeFrame(x, y, width, height, delay, colorMap, rasterBits))
+    if (!encodeFrame(x, y, width, height, delay, colorMap, m_rasterBits.data()))
         return false;
 
     return true;
@@ -169,6 +188,10 @@ bool GifEncoder::close() {
     m_gifFileHandler = nullptr;
     reset();
 
+    GifFreeMapObject((ColorMapObject *) m_colorMap);
+    m_colorMap = nullptr;
+    m_rasterBits = {};
+
     return true;
 }
 
@@ -189,17 +212,23 @@ bool GifEncoder::encodeFrame(int x, int y, int width, int height, int delay, voi
     gcb.DisposalMode = DISPOSE_DO_NOT;
     gcb.UserInputFlag = false;
     gcb.DelayTime = delay;
-    gcb.TransparentColor = NO_TRANSPARENT_COLOR;
+    gcb.TransparentColor = TRANSPARENT_INDEX;
     uint8_t gcbBytes[4];
     EGifGCBToExtension(&gcb, gcbBytes);
     GifAddExtensionBlockFor(gifImage, GRAPHICS_EXT_FUNC_CODE, sizeof(gcbBytes), gcbBytes);
 
-    if (EGifWritePictures(m_gifFile) == GIF_ERROR) {
+    const bool written = EGifWritePictures(m_gifFile) != GIF_ERROR;
+
+    // MICHEL: the color map and raster are owned by the encoder
+    gifImage->ImageDesc.ColorMap = nullptr;
+    gifImage->RasterBits = nullptr;
+    GifFreeSavedImages(m_gifFile);
+
+    if (!written) {
         EGifCloseFile(m_gifFile, nullptr);
         m_gifFileHandler = nullptr;
         return false;
     }
 
-    GifFreeSavedImages(m_gifFile);
     return true;
 }
@@ -6,6 +6,7 @@
 #ifndef GIF_GIFENCODER_H
 #define GIF_GIFENCODER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -41,13 +42,14 @@ public:
      * add frame
      *
      * @param format pixel format
-     * @param frame frame data
+     * @param frame frame data, RGBA pixels with alpha 0 are transparent
      * @param width frame width
      * @param height frame height
+     * @param stride bytes from the start of a row to the next
      * @param delay delay time 0.01s
      * @return
      */
-    bool push(const uint8_t *frame, int x, int y, int width, int height, int delay);
+    bool push(const uint8_t *frame, int x, int y, int width, int height, int stride, int delay);
 
     /**
      * close gif file
@@ -66,6 +68,8 @@ private:
 
 private:
     void *m_gifFileHandler = nullptr;
+    void *m_colorMap = nullptr;
+    std::vector<uint8_t> m_rasterBits;
     int m_quality = 10;
     int m_frameWidth = -1;
     int m_frameHeight = -1;
@@ -26,7 +26,7 @@
 /* Network Definitions
    ------------------- */
 
-#define maxnetpos    255
+#define maxnetpos    (netsize - 1)
 #define netbiasshift    4            /* bias for colour values */
 #define ncycles        100            /* no. of learning cycles */
 
@@ -40,7 +40,6 @@
 #define betagamma    65536
 
 /* defs for decreasing radius factor */
-#define initrad        32        /* for 256 cols, radius starts */
 #define radiusbiasshift    6            /* at 32.0 biased by 6 bits */
 #define radiusbias    64
 #define initradius    2048    /* and decreases by a */
@@ -49,7 +48,6 @@
 /* defs for decreasing alpha factor */
 #define alphabiasshift    10            /* alpha starts at 1.0 */
 #define initalpha    1024
-int alphadec;                    /* biased by 10 bits */
 
 /* radbias and alpharadbias used for radpower calculation */
 #define radbiasshift    8
@@ -58,38 +56,22 @@ int alphadec;                    /* biased by 10 bits */
 #define alpharadbias    262144
 
 
-/* Types and Global Variables
-   -------------------------- */
-
-static const unsigned char *thepicture;        /* the input image itself */
-static int lengthcount;                /* lengthcount = H*W*3 */
-
-static int samplefac;                /* sampling factor 1..30 */
-
-
-typedef int pixel[4];                /* BGRc */
-static pixel network[netsize];            /* the network itself */
-
-static int netindex[256];            /* for network lookup - really 256 */
-
-static int bias[netsize];            /* bias and freq arrays for learning */
-static int freq[netsize];
-static int radpower[initrad];            /* radpower for precomputation */
-
-
-int getNetwork(int i, int j) {
+int NeuQuant::getNetwork(int i, int j) const {
     return network[i][j];
 }
 
 /* Initialise network in range (0,0,0) to (255,255,255) and set parameters
    ----------------------------------------------------------------------- */
 
-void initnet(const unsigned char *thepic, int len, int sample) {
+// MICHEL: rows can have a stride larger than their pixels
+void NeuQuant::initnet(const unsigned char *thepic, int len, int sample, int rowlen, int stride) {
     int i;
     int *p;
 
     thepicture = thepic;
     lengthcount = len;
+    rowbytes = rowlen;
+    rowstride = stride;
     samplefac = sample;
 
     for (i = 0; i < netsize; i++) {
@@ -104,7 +86,7 @@ void initnet(const unsigned char *thepic, int len, int sample) {
 /* Unbias network to give byte values 0..255 and record position i to prepare for sort
    ----------------------------------------------------------------------------------- */
 
-void unbiasnet() {
+void NeuQuant::unbiasnet() {
     int i, j, temp;
 
     for (i = 0; i < netsize; i++) {
@@ -123,7 +105,7 @@ void unbiasnet() {
 /* Output colour map
    ----------------- */
 
-void writecolourmap(FILE *f) {
+void NeuQuant::writecolourmap(FILE *f) const {
     int i, j;
 
     for (i = 2; i >= 0; i--)
@@ -131,7 +113,7 @@ void writecolourmap(FILE *f) {
             putc(network[j][i], f);
 }
 
-void getcolourmap(uint8_t *colorMap) {
+void NeuQuant::getcolourmap(uint8_t *colorMap) const {
     int *index = new int[netsize];
     for (int i = 0; i < netsize; i++)
         index[network[i][3]] = i;
@@ -151,7 +133,7 @@ void getcolourmap(uint8_t *colorMap) {
 /* Insertion sort of network and building of netindex[0..255] (to do after unbias)
    ------------------------------------------------------------------------------- */
 
-void inxbuild() {
+void NeuQuant::inxbuild() {
     int i, j, smallpos, smallval;
     int *p, *q;
     int previouscol, startpos;
@@ -202,9 +184,9 @@ void inxbuild() {
 /* Search for BGR values 0..255 (after net is unbiased) and return colour index
    ---------------------------------------------------------------------------- */
 
-int inxsearch(int b, int g, int r) {
+int NeuQuant::inxsearch(int b, int g, int r) const {
     int i, j, dist, a, bestd;
-    int *p;
+    const int *p;
     int best;
 
     bestd = 1000;        /* biggest possible dist is 256*3 */
@@ -263,7 +245,7 @@ int inxsearch(int b, int g, int r) {
 /* Search for biased BGR values
    ---------------------------- */
 
-int contest(int b, int g, int r) {
+int NeuQuant::contest(int b, int g, int r) {
     /* finds closest neuron (min dist) and updates freq */
     /* finds best neuron (min dist-bias) and returns position */
     /* for frequently chosen neurons, freq[i] is high and bias[i] is negative */
@@ -312,7 +294,7 @@ int contest(int b, int g, int r) {
 /* Move neuron i towards biased (b,g,r) by factor alpha
    ---------------------------------------------------- */
 
-void altersingle(int alpha, int i, int b, int g, int r) {
+void NeuQuant::altersingle(int alpha, int i, int b, int g, int r) {
     int *n;
 
 //	printf("New point %d: ", i);
@@ -332,7 +314,7 @@ void altersingle(int alpha, int i, int b, int g, int r) {
 /* Move adjacent neurons by precomputed alpha*(1-((i-j)^2/[r]^2)) in radpower[|i-j|]
    --------------------------------------------------------------------------------- */
 
-void alterneigh(int rad, int i, int b, int g, int r) {
+void NeuQuant::alterneigh(int rad, int i, int b, int g, int r) {
     int j, k, lo, hi, a;
     int *p, *q;
 
@@ -379,18 +361,22 @@ void alterneigh(int rad, int i, int b, int g, int r) {
 /* Main Learning Loop
    ------------------ */
 
-// MICHEL: changed to 4 bytes RGBA pixels
-void learn() {
+// MICHEL: changed to 4 bytes RGBA pixels in strided rows
+void NeuQuant::learn() {
     int i, j, b, g, r;
     int radius, rad, alpha, step, delta, samplepixels;
+    int pos;
     const unsigned char *p;
-    const unsigned char *lim;
+
+    // MICHEL: learn from all pixels of small images, as for the original images
+    // smaller than minpicturebytes. Partial frames can be tiny.
+    if (lengthcount < 4 * prime4) samplefac = 1;
 
     alphadec = 30 + ((samplefac - 1) / 3);
-    p = thepicture;
-    lim = thepicture + lengthcount;
+    pos = 0;
     samplepixels = lengthcount / (4 * samplefac);
     delta = samplepixels / ncycles;
+    if (delta == 0) delta = 1;
     alpha = initalpha;
     radius = initradius;
 
@@ -401,7 +387,8 @@ void learn() {
 
 //	fprintf(stderr,"beginning 1D learning: initial radius=%d\n", rad);
 
-    if ((lengthcount % prime1) != 0) step = 4 * prime1;
+    if (lengthcount < 4 * prime4) step = 4;
+    else if ((lengthcount % prime1) != 0) step = 4 * prime1;
     else {
         if ((lengthcount % prime2) != 0) step = 4 * prime2;
         else {
@@ -412,16 +399,21 @@ void learn() {
 
     i = 0;
     while (i < samplepixels) {
-        b = p[2] << netbiasshift;
-        g = p[1] << netbiasshift;
-        r = p[0] << netbiasshift;
-        j = contest(b, g, r);
+        p = thepicture + (pos / rowbytes) * rowstride + pos % rowbytes;
+
+        // MICHEL: transparent pixels do not get a colour
+        if (p[3] != 0) {
+            b = p[2] << netbiasshift;
+            g = p[1] << netbiasshift;
+            r = p[0] << netbiasshift;
+            j = contest(b, g, r);
 
-        altersingle(alpha, j, b, g, r);
-        if (rad) alterneigh(rad, j, b, g, r);   /* alter neighbours */
+            altersingle(alpha, j, b, g, r);
+            if (rad) alterneigh(rad, j, b, g, r);   /* alter neighbours */
+        }
 
-        p += step;
-        if (p >= lim) p -= lengthcount;
+        pos += step;
+        if (pos >= lengthcount) pos -= lengthcount;
 
         i++;
         if (i % delta == 0) {
@@ -25,7 +25,9 @@
 #include <cstdint>
 
 
-#define netsize		256			/* number of colours used */
+// MICHEL: the last entry of a 256 colour map is kept for transparency
+#define netsize		255			/* number of colours used */
+#define initrad		32			/* for 256 cols, radius starts */
 
 
 /* For 256 colours, fixed arrays need 8kb, plus space for the image
@@ -41,43 +43,71 @@
 
 #define minpicturebytes	(3*prime4)		/* minimum size for input image */
 
-int getNetwork(int i, int j);
-
-/* Initialise network in range (0,0,0) to (255,255,255) and set parameters
-   ----------------------------------------------------------------------- */
-void initnet(const unsigned char *thepic, int len, int sample);
-
-/* Unbias network to give byte values 0..255 and record position i to prepare for sort
-   ----------------------------------------------------------------------------------- */
-void unbiasnet();	/* can edit this function to do output of colour map */
-
-/* Output colour map
-   ----------------- */
-void writecolourmap(FILE *f);
-
-void getcolourmap(uint8_t *colorMap);
-
-/* Insertion sort of network and building of netindex[0..255] (to do after unbias)
-   ------------------------------------------------------------------------------- */
-void inxbuild();
-
-/* Search for BGR values 0..255 (after net is unbiased) and return colour index
-   ---------------------------------------------------------------------------- */
-int inxsearch(int b, int g, int r);
-
-/* Main Learning Loop
-   ------------------ */
-void learn();
+// MICHEL: the state is kept in an instance instead of globals, such that
+// images can be quantized on multiple threads at the same time.
+class NeuQuant {
+public:
+    int getNetwork(int i, int j) const;
+
+    /* Initialise network in range (0,0,0) to (255,255,255) and set parameters
+       len is the number of pixel bytes, rowlen the pixel bytes in a row and
+       stride the bytes from the start of a row to the next.
+       ----------------------------------------------------------------------- */
+    void initnet(const unsigned char *thepic, int len, int sample, int rowlen, int stride);
+
+    /* Unbias network to give byte values 0..255 and record position i to prepare for sort
+       ----------------------------------------------------------------------------------- */
+    void unbiasnet();	/* can edit this function to do output of colour map */
+
+    /* Output colour map
+       ----------------- */
+    void writecolourmap(FILE *f) const;
+
+    void getcolourmap(uint8_t *colorMap) const;
+
+    /* Insertion sort of network and building of netindex[0..255] (to do after unbias)
+       ------------------------------------------------------------------------------- */
+    void inxbuild();
+
+    /* Search for BGR values 0..255 (after net is unbiased) and return colour index
+       ---------------------------------------------------------------------------- */
+    int inxsearch(int b, int g, int r) const;
+
+    /* Main Learning Loop
+       ------------------ */
+    void learn();
+
+private:
+    typedef int pixel[4];                /* BGRc */
+
+    int contest(int b, int g, int r);
+    void altersingle(int alpha, int i, int b, int g, int r);
+    void alterneigh(int rad, int i, int b, int g, int r);
+
+    const unsigned char *thepicture = nullptr;  /* the input image itself */
+    int lengthcount = 0;                /* lengthcount = H*W*3 */
+    int rowbytes = 0;                   /* bytes of pixels in a row */
+    int rowstride = 0;                  /* bytes from row to row */
+    int samplefac = 0;                  /* sampling factor 1..30 */
+    int alphadec = 0;                   /* biased by 10 bits */
+
+    pixel network[netsize];             /* the network itself */
+    int netindex[256];                  /* for network lookup - really 256 */
+    int bias[netsize];                  /* bias and freq arrays for learning */
+    int freq[netsize];
+    int radpower[initrad];              /* radpower for precomputation */
+};
 
 /* Program Skeleton
    ----------------
   [select samplefac in range 1..30]
   pic = (unsigned char*) malloc(3*width*height);
   [read image from input file into pic]
-	initnet(pic,3*width*height,samplefac);
-	learn();
-	unbiasnet();
-	[write output image header, using writecolourmap(f),
+	NeuQuant nq;
+	nq.initnet(pic,3*width*height,samplefac,3*width,3*width);
+	nq.learn();
+	nq.unbiasnet();
+	[write output image header, using nq.writecolourmap(f),
 	possibly editing the loops in that function]
-	inxbuild();
-	[write output image using inxsearch(b,g,r)]		*/
+	nq.inxbuild();
+	[write output image using nq.inxsearch(b,g,r)]		*/
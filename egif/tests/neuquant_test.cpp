@@ -0,0 +1,105 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "../algorithm/NeuQuant.h"
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using ColorMap = std::array<uint8_t, netsize * 3>;
+
+constexpr int WIDTH = 320;
+constexpr int HEIGHT = 240;
+constexpr int STRIDE = (WIDTH + 8) * 4; // rows are padded as in a view on a larger frame
+constexpr int QUALITY = 10; // sampling factor of GifEncoderWrapper
+
+// Each thread quantizes the image this many times, such that the threads run
+// at the same time for a while.
+constexpr int THREAD_RUNS = 20;
+
+// Fixed RGBA pixels: colour gradients with rings and a transparent block, such
+// that the network learns many different colours and skips transparent pixels.
+std::vector<uint8_t> createPixels()
+{
+    std::vector<uint8_t> pixels(std::size_t(STRIDE) * HEIGHT, 0);
+
+    for (int y = 0; y < HEIGHT; ++y)
+    {
+        uint8_t* row = pixels.data() + std::size_t(y) * STRIDE;
+
+        for (int x = 0; x < WIDTH; ++x)
+        {
+            uint8_t* p = row + x * 4;
+            const int dx = x - WIDTH / 2;
+            const int dy = y - HEIGHT / 2;
+            const int ring = (dx * dx + dy * dy) / 64;
+
+            p[0] = uint8_t(x * 255 / WIDTH);
+            p[1] = uint8_t(y * 255 / HEIGHT);
+            p[2] = uint8_t(ring * 37);
+            p[3] = (x / 40 == 2 && y / 40 == 3) ? 0 : 255;
+        }
+    }
+
+    return pixels;
+}
+
+// Same steps as getColorMap in GifEncoder.cpp
+void quantize(const std::vector<uint8_t>& pixels, ColorMap& colorMap)
+{
+    NeuQuant neuQuant;
+    neuQuant.initnet(pixels.data(), WIDTH * HEIGHT * 4, QUALITY, WIDTH * 4, STRIDE);
+    neuQuant.learn();
+    neuQuant.unbiasnet();
+    neuQuant.inxbuild();
+    neuQuant.getcolourmap(colorMap.data());
+}
+
+void quantizeRuns(const std::vector<uint8_t>& pixels, const ColorMap& expected, ColorMap& colorMap, bool& identical)
+{
+    identical = true;
+
+    for (int i = 0; i < THREAD_RUNS; ++i)
+    {
+        colorMap.fill(0);
+        quantize(pixels, colorMap);
+
+        if (std::memcmp(colorMap.data(), expected.data(), colorMap.size()) != 0)
+            identical = false;
+    }
+}
+
+}
+
+// The quantizer must give the same colour map on any thread, while other
+// threads quantize at the same time.
+int main()
+{
+    const std::vector<uint8_t> pixels = createPixels();
+
+    ColorMap serialMap{};
+    quantize(pixels, serialMap);
+
+    ColorMap threadMap1{};
+    ColorMap threadMap2{};
+    bool identical1 = false;
+    bool identical2 = false;
+
+    std::thread thread1(quantizeRuns, std::cref(pixels), std::cref(serialMap), std::ref(threadMap1), std::ref(identical1));
+    std::thread thread2(quantizeRuns, std::cref(pixels), std::cref(serialMap), std::ref(threadMap2), std::ref(identical2));
+    thread1.join();
+    thread2.join();
+
+    const bool passed = identical1 && identical2 &&
+                        std::memcmp(threadMap1.data(), serialMap.data(), serialMap.size()) == 0 &&
+                        std::memcmp(threadMap2.data(), serialMap.data(), serialMap.size()) == 0;
+
+    std::printf("%s neuquant: colour maps of serial and threaded runs %s\n",
+                passed ? "PASS" : "FAIL", passed ? "are identical" : "differ");
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
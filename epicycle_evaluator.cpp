@@ -0,0 +1,80 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "epicycle_evaluator.h"
+#include <QLineF>
+#include <QtMath>
+
+namespace SpiralFun {
+
+void EpicycleEvaluator::init(const std::vector<QPointF>& centers, const std::vector<int>& speeds)
+{
+    Q_ASSERT(!centers.empty());
+    Q_ASSERT(centers.size() == speeds.size());
+    mOrigin = centers[0];
+    mArms.clear();
+    mArms.reserve(centers.size() - 1);
+    int speed = 0;
+
+    for (unsigned i = 1; i < centers.size(); ++i)
+    {
+        const QLineF line(centers[i - 1], centers[i]);
+        speed += speeds[i];
+        mArms.push_back({ line.length(), qDegreesToRadians(line.angle()), speed });
+    }
+}
+
+void EpicycleEvaluator::evaluate(qreal angle, std::vector<QPointF>& centers) const
+{
+    centers.resize(size());
+    centers[0] = mOrigin;
+    QPointF center = mOrigin;
+
+    for (unsigned i = 0; i < mArms.size(); ++i)
+    {
+        const Arm& arm = mArms[i];
+
+        // A positive speed is clockwise. The y-axis points downwards.
+        const qreal a = arm.mStartAngle - angle * arm.mSpeed;
+        center += QPointF(qCos(a) * arm.mLength, -qSin(a) * arm.mLength);
+        centers[i + 1] = center;
+    }
+}
+
+QPointF EpicycleEvaluator::getCenter(unsigned index, qreal angle) const
+{
+    Q_ASSERT(index < size());
+    QPointF center = mOrigin;
+
+    for (unsigned i = 0; i < index; ++i)
+    {
+        const Arm& arm = mArms[i];
+        const qreal a = arm.mStartAngle - angle * arm.mSpeed;
+        center += QPointF(qCos(a) * arm.mLength, -qSin(a) * arm.mLength);
+    }
+
+    return center;
+}
+
+qreal EpicycleEvaluator::getMaxSpeed(unsigned index) const
+{
+    Q_ASSERT(index < size());
+    qreal speed = 0.0;
+
+    for (unsigned i = 0; i < index; ++i)
+        speed += mArms[i].mLength * std::abs(mArms[i].mSpeed);
+
+    return speed;
+}
+
+qreal EpicycleEvaluator::getMaxAcceleration(unsigned index) const
+{
+    Q_ASSERT(index < size());
+    qreal acceleration = 0.0;
+
+    for (unsigned i = 0; i < index; ++i)
+        acceleration += mArms[i].mLength * mArms[i].mSpeed * mArms[i].mSpeed;
+
+    return acceleration;
+}
+
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QPointF>
+#include <vector>
+
+namespace SpiralFun {
+
+// Calculates the circle centers for a play angle directly as a sum of rotating
+// vectors. Circle i rotates around circle i-1 with the sum of the speeds of
+// circles 1..i, so there is no need to step each circle through all its
+// rotations.
+//
+// The centers are equal to the ones calculated by repeatedly rotating the
+// circles within floating point precision (< 1e-6 pixel for all valid configs).
+class EpicycleEvaluator
+{
+public:
+    void init(const std::vector<QPointF>& centers, const std::vector<int>& speeds);
+    unsigned size() const { return mArms.size() + 1; }
+
+    // Calculate the centers of all circles at the given angle of circle 1.
+    void evaluate(qreal angle, std::vector<QPointF>& centers) const;
+
+    QPointF getCenter(unsigned index, qreal angle) const;
+
+    // Upper bound of the distance (pixels) the center of a circle moves when
+    // the angle changes 1 radian.
+    qreal getMaxSpeed(unsigned index) const;
+
+    // Upper bound of the second derivative of the center to the angle.
+    qreal getMaxAcceleration(unsigned index) const;
+
+    // Arm i is the vector from the center of circle i to circle i+1. Its angle
+    // is mStartAngle - angle * mSpeed.
+    struct Arm
+    {
+        qreal mLength;
+        qreal mStartAngle;
+        int mSpeed;
+    };
+
+    const QPointF& getOrigin() const { return mOrigin; }
+    const std::vector<Arm>& getArms() const { return mArms; }
+
+private:
+    QPointF mOrigin;
+    std::vector<Arm> mArms;
+};
+
+}
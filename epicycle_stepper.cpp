@@ -0,0 +1,65 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "epicycle_stepper.h"
+#include <QtMath>
+
+namespace SpiralFun {
+
+void EpicycleStepper::init(const EpicycleEvaluator& evaluator, qreal angle, qreal stepAngle)
+{
+    mEvaluator = &evaluator;
+    mStartAngle = angle;
+    mStepAngle = stepAngle;
+    mStepCount = 0;
+    mArms.clear();
+
+    for (const auto& arm : evaluator.getArms())
+    {
+        // The angle of an arm changes by -speed * stepAngle per step.
+        const qreal a = -arm.mSpeed * stepAngle;
+        mArms.push_back({ {}, qCos(a), qSin(a) });
+    }
+
+    resync();
+}
+
+void EpicycleStepper::step(std::vector<QPointF>& centers)
+{
+    Q_ASSERT(mEvaluator);
+    ++mStepCount;
+
+    if (mStepCount % RESYNC_STEPS == 0)
+    {
+        resync();
+    }
+    else
+    {
+        // Rotate clockwise on screen as the y-axis points downwards.
+        for (Arm& arm : mArms)
+        {
+            const QPointF& v = arm.mVector;
+            arm.mVector = QPointF(v.x() * arm.mStepCos + v.y() * arm.mStepSin,
+                                  v.y() * arm.mStepCos - v.x() * arm.mStepSin);
+        }
+    }
+
+    centers.resize(mArms.size() + 1);
+    centers[0] = mEvaluator->getOrigin();
+
+    for (unsigned i = 0; i < mArms.size(); ++i)
+        centers[i + 1] = centers[i] + mArms[i].mVector;
+}
+
+void EpicycleStepper::resync()
+{
+    const qreal angle = getAngle();
+    const auto& arms = mEvaluator->getArms();
+
+    for (unsigned i = 0; i < mArms.size(); ++i)
+    {
+        const qreal a = arms[i].mStartAngle - angle * arms[i].mSpeed;
+        mArms[i].mVector = QPointF(qCos(a) * arms[i].mLength, -qSin(a) * arms[i].mLength);
+    }
+}
+
+}
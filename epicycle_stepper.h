@@ -0,0 +1,43 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "epicycle_evaluator.h"
+#include <QPointF>
+#include <vector>
+
+namespace SpiralFun {
+
+// Steps the circle centers with a fixed angle without trigonometric functions.
+// Each arm is a vector that is rotated by a precomputed rotation per step.
+// Rounding errors accumulate, so every RESYNC_STEPS steps the vectors are
+// recalculated by the EpicycleEvaluator.
+class EpicycleStepper
+{
+public:
+    static constexpr unsigned RESYNC_STEPS = 1024;
+
+    void init(const EpicycleEvaluator& evaluator, qreal angle, qreal stepAngle);
+    qreal getAngle() const { return mStartAngle + mStepCount * mStepAngle; }
+    qreal getStepAngle() const { return mStepAngle; }
+
+    // Advance one step and calculate the centers of all circles.
+    void step(std::vector<QPointF>& centers);
+
+private:
+    struct Arm
+    {
+        QPointF mVector;
+        qreal mStepCos;
+        qreal mStepSin;
+    };
+
+    void resync();
+
+    const EpicycleEvaluator* mEvaluator = nullptr;
+    std::vector<Arm> mArms;
+    qreal mStartAngle = 0.0;
+    qreal mStepAngle = 0.0;
+    unsigned mStepCount = 0;
+};
+
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "flash_pool.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace SpiralFun {
+
+namespace {
+constexpr qreal START_RADIUS = 8.0;
+
+// The radius shrinks by a pixel per interval. A flash is gone at radius 1.
+constexpr qint64 SHRINK_INTERVAL_MS = 50;
+
+// Unit vectors to the corners of a disc.
+const auto DISC_CORNERS = []{
+    std::array<QPointF, FlashPool::DISC_SEGMENTS> corners;
+
+    for (unsigned i = 0; i < corners.size(); ++i)
+    {
+        const qreal angle = 2 * M_PI * i / corners.size();
+        corners[i] = QPointF(std::cos(angle), std::sin(angle));
+    }
+
+    return corners;
+}();
+}
+
+FlashPool::FlashPool()
+{
+    mClock.start();
+}
+
+void FlashPool::add(const QPointF& center, const QColor& color)
+{
+    mFlashes[mNext] = { center, color, mClock.elapsed() };
+    mNext = (mNext + 1) % SIZE;
+}
+
+void FlashPool::clear()
+{
+    for (auto& flash : mFlashes)
+        flash.mStartTime = -1;
+}
+
+bool FlashPool::isActive() const
+{
+    const qint64 now = mClock.elapsed();
+    return std::any_of(mFlashes.begin(), mFlashes.end(), [this, now](const Flash& flash){
+        return getRadius(flash, now) > 0.0;
+    });
+}
+
+qreal FlashPool::getRadius(const Flash& flash, qint64 now) const
+{
+    if (flash.mStartTime < 0)
+        return 0.0;
+
+    const qreal radius = START_RADIUS - (now - flash.mStartTime) / SHRINK_INTERVAL_MS;
+    return radius > 1.0 ? radius : 0.0;
+}
+
+void FlashPool::writeVertices(QSGGeometry::ColoredPoint2D* vertices) const
+{
+    const qint64 now = mClock.elapsed();
+
+    for (const Flash& flash : mFlashes)
+    {
+        const qreal radius = getRadius(flash, now);
+
+        if (radius <= 0.0)
+        {
+            std::fill(vertices, vertices + VERTICES_PER_FLASH, QSGGeometry::ColoredPoint2D{});
+            vertices += VERTICES_PER_FLASH;
+            continue;
+        }
+
+        const uchar r = flash.mColor.red();
+        const uchar g = flash.mColor.green();
+        const uchar b = flash.mColor.blue();
+        auto vertex = [r, g, b](const QPointF& p) -> QSGGeometry::ColoredPoint2D {
+            return { float(p.x()), float(p.y()), r, g, b, 255 };
+        };
+
+        for (unsigned i = 0; i < DISC_SEGMENTS; ++i)
+        {
+            *vertices++ = vertex(flash.mCenter);
+            *vertices++ = vertex(flash.mCenter + radius * DISC_CORNERS[i]);
+            *vertices++ = vertex(flash.mCenter + radius * DISC_CORNERS[(i + 1) % DISC_SEGMENTS]);
+        }
+    }
+}
+
+}
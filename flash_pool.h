@@ -0,0 +1,52 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QColor>
+#include <QElapsedTimer>
+#include <QPointF>
+#include <QSGGeometry>
+#include <array>
+
+namespace SpiralFun {
+
+// Highlights of played notes. A flash is a disc that shrinks till it is gone.
+// The flashes live in a fixed number of slots that are drawn as vertex colored
+// triangles in a single geometry, such that there are no allocations per note
+// and the drawing cost does not depend on the note rate. When all slots are in
+// use, the oldest flash is replaced.
+class FlashPool
+{
+public:
+    static constexpr unsigned SIZE = 64;
+    static constexpr unsigned DISC_SEGMENTS = 16;
+    static constexpr unsigned VERTICES_PER_FLASH = DISC_SEGMENTS * 3;
+    static constexpr unsigned VERTEX_COUNT = SIZE * VERTICES_PER_FLASH;
+
+    FlashPool();
+
+    void add(const QPointF& center, const QColor& color);
+    void clear();
+
+    // True while a flash is shown.
+    bool isActive() const;
+
+    // Write VERTEX_COUNT vertices for the flashes at the current time. The
+    // vertices of empty slots form degenerate triangles.
+    void writeVertices(QSGGeometry::ColoredPoint2D* vertices) const;
+
+private:
+    struct Flash
+    {
+        QPointF mCenter;
+        QColor mColor;
+        qint64 mStartTime = -1;
+    };
+
+    qreal getRadius(const Flash& flash, qint64 now) const;
+
+    std::array<Flash, SIZE> mFlashes;
+    unsigned mNext = 0;
+    QElapsedTimer mClock;
+};
+
+}
@@ -0,0 +1,118 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "frame_differ.h"
+#include <bit>
+#include <cstring>
+
+namespace SpiralFun {
+
+namespace {
+
+// Alpha is the 4th byte of an RGBA pixel.
+constexpr uint32_t ALPHA_MASK = std::endian::native == std::endian::little ? 0xff000000u : 0x000000ffu;
+
+const uint32_t* frameRow(const QImage& frame, int y)
+{
+    return reinterpret_cast<const uint32_t*>(frame.constScanLine(y));
+}
+
+uint32_t* frameRow(QImage& frame, int y)
+{
+    return reinterpret_cast<uint32_t*>(frame.scanLine(y));
+}
+
+}
+
+void FrameDiffer::reset(const QSize& size)
+{
+    mSize = size;
+    mCanvas.assign(std::size_t(size.width()) * size.height(), 0);
+    mCanvasValid = false;
+}
+
+QRect FrameDiffer::diff(QImage& frame, const QPoint& position)
+{
+    Q_ASSERT(frame.depth() == 32);
+    Q_ASSERT(QRect(QPoint(0, 0), mSize).contains(QRect(position, frame.size())));
+
+    const QRect changedRect = mCanvasValid ? findChangedRect(frame, position) : QRect(position, frame.size());
+    const int width = changedRect.width();
+
+    for (int y = changedRect.top(); y <= changedRect.bottom(); ++y)
+    {
+        uint32_t* pixels = frameRow(frame, y - position.y()) + changedRect.left() - position.x();
+        uint32_t* canvas = canvasRow(y) + changedRect.left();
+
+        for (int x = 0; x < width; ++x)
+        {
+            const uint32_t pixel = pixels[x];
+
+            if (!mCanvasValid || pixel != canvas[x])
+            {
+                pixels[x] = pixel | ALPHA_MASK;
+                canvas[x] = pixel;
+            }
+            else
+            {
+                pixels[x] = UNCHANGED_PIXEL;
+            }
+        }
+    }
+
+    // The canvas is only valid when the first frame covered all of it.
+    if (!mCanvasValid)
+        mCanvasValid = changedRect == QRect(QPoint(0, 0), mSize);
+
+    return changedRect;
+}
+
+// Equal rows are skipped with memcmp, which compares many pixels per instruction.
+// In a changed row only the pixels outside the columns found so far are compared.
+QRect FrameDiffer::findChangedRect(const QImage& frame, const QPoint& position) const
+{
+    const int width = frame.width();
+    const std::size_t rowBytes = std::size_t(width) * sizeof(uint32_t);
+    int top = -1;
+    int bottom = -1;
+    int left = width;
+    int right = -1;
+
+    for (int y = 0; y < frame.height(); ++y)
+    {
+        const uint32_t* src = frameRow(frame, y);
+        const uint32_t* canvas = canvasRow(y + position.y()) + position.x();
+
+        if (std::memcmp(src, canvas, rowBytes) == 0)
+            continue;
+
+        if (top < 0)
+            top = y;
+
+        bottom = y;
+
+        for (int x = 0; x < left; ++x)
+        {
+            if (src[x] != canvas[x])
+            {
+                left = x;
+                break;
+            }
+        }
+
+        for (int x = width - 1; x > right; --x)
+        {
+            if (src[x] != canvas[x])
+            {
+                right = x;
+                break;
+            }
+        }
+    }
+
+    if (top < 0)
+        return {};
+
+    return QRect(left, top, right - left + 1, bottom - top + 1).translated(position);
+}
+
+}
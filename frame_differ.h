@@ -0,0 +1,47 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QImage>
+#include <QRect>
+#include <cstdint>
+#include <vector>
+
+namespace SpiralFun {
+
+// Finds the pixels of a frame that changed compared to what the previous frames
+// show, such that an encoder that keeps the previous frames on screen only needs
+// to encode those. The recording rect of a frame covers the circles that moved,
+// most of which is unchanged.
+//
+// Frames must have 32 bit RGBA pixels. The frames so far are kept in a canvas
+// of the full frame size.
+class FrameDiffer
+{
+public:
+    // Unchanged pixels in the changed rect have this value, i.e. alpha is 0.
+    static constexpr uint32_t UNCHANGED_PIXEL = 0;
+
+    // Start with an unknown canvas, so the next frame is fully changed.
+    void reset(const QSize& size);
+
+    // Compare the frame at the position on the canvas with the canvas and put it
+    // on the canvas. Returns the bounding rect of the changed pixels on the canvas.
+    // The pixels of the frame in that rect are overwritten in place: changed
+    // pixels are made opaque and unchanged pixels become UNCHANGED_PIXEL. The
+    // rect is empty when nothing changed.
+    //
+    // A frame that shares its pixels, e.g. a view on a read-only buffer, is
+    // detached first, which copies it.
+    QRect diff(QImage& frame, const QPoint& position);
+
+private:
+    QRect findChangedRect(const QImage& frame, const QPoint& position) const;
+    uint32_t* canvasRow(int y) { return mCanvas.data() + y * mSize.width(); }
+    const uint32_t* canvasRow(int y) const { return mCanvas.data() + y * mSize.width(); }
+
+    QSize mSize;
+    std::vector<uint32_t> mCanvas;
+    bool mCanvasValid = false;
+};
+
+}
@@ -0,0 +1,69 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "frame_pool.h"
+#include <algorithm>
+
+namespace SpiralFun {
+
+FramePool::FramePool(qsizetype minBytes) :
+    mMinBytes(minBytes)
+{
+}
+
+FramePool::~FramePool()
+{
+    for (Buffer* buffer : mFreeBuffers)
+        delete buffer;
+}
+
+QImage FramePool::acquire(const QSize& size, QImage::Format format)
+{
+    Q_ASSERT(!size.isEmpty());
+    const qsizetype bytesPerLine = (qsizetype(size.width()) * QImage::toPixelFormat(format).bitsPerPixel() + 31) / 32 * 4;
+    const qsizetype bytes = bytesPerLine * size.height();
+    Buffer* buffer = nullptr;
+
+    {
+        std::lock_guard lock(mMutex);
+
+        if (!mFreeBuffers.empty())
+        {
+            buffer = mFreeBuffers.back();
+            mFreeBuffers.pop_back();
+        }
+    }
+
+    if (!buffer)
+        buffer = new Buffer;
+
+    if (buffer->mSize < bytes)
+    {
+        buffer->mSize = std::max(bytes, mMinBytes);
+        buffer->mBits = std::make_unique_for_overwrite<uchar[]>(buffer->mSize);
+        ++mAllocationCount;
+    }
+
+    buffer->mPool = weak_from_this();
+    return QImage(buffer->mBits.get(), size.width(), size.height(), bytesPerLine, format,
+                  releaseBuffer, buffer);
+}
+
+// Called when the last copy of an acquired image is destroyed, on any thread.
+void FramePool::releaseBuffer(void* info)
+{
+    auto* buffer = static_cast<Buffer*>(info);
+
+    if (auto pool = buffer->mPool.lock())
+        pool->release(buffer);
+    else
+        delete buffer;
+}
+
+void FramePool::release(Buffer* buffer)
+{
+    buffer->mPool.reset();
+    std::lock_guard lock(mMutex);
+    mFreeBuffers.push_back(buffer);
+}
+
+}
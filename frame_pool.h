@@ -0,0 +1,51 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QImage>
+#include <QSize>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SpiralFun {
+
+// Pixel buffers for recorded frames that circulate between the scene grabber and
+// the encoder thread. An acquired frame is a QImage on a pooled buffer. When the
+// last copy of the image is destroyed, after encoding, the buffer goes back to the
+// pool. In steady state the number of buffers is bounded by the frames in flight
+// and no buffers are allocated per frame.
+//
+// The pool must be owned by a shared pointer. Images may outlive the pool, their
+// buffers are deleted then.
+class FramePool : public std::enable_shared_from_this<FramePool>
+{
+public:
+    // Buffers are at least minBytes large, such that frames of different sizes
+    // up to a full frame can share the buffers.
+    explicit FramePool(qsizetype minBytes = 0);
+    ~FramePool();
+
+    // Get a frame with packed rows. The pixels are uninitialized.
+    QImage acquire(const QSize& size, QImage::Format format);
+
+    int getAllocationCount() const { return mAllocationCount; }
+
+private:
+    struct Buffer
+    {
+        std::unique_ptr<uchar[]> mBits;
+        qsizetype mSize = 0;
+        std::weak_ptr<FramePool> mPool; // set while the buffer is in use
+    };
+
+    static void releaseBuffer(void* info);
+    void release(Buffer* buffer);
+
+    const qsizetype mMinBytes;
+    std::mutex mMutex;
+    std::vector<Buffer*> mFreeBuffers; // guarded by mMutex
+    std::atomic_int mAllocationCount = 0;
+};
+
+}
@@ -14,6 +14,7 @@ bool GifEncoderWrapper::open(const QString& fileName, int width, int height, int
     Q_ASSERT(fps > 0);
     mFrameDuration = 100 / fps;
     mGifEncoder = std::make_unique<GifEncoder>();
+    mFrameDiffer.reset(QSize(width, height));
     return mGifEncoder->open(fileName.toStdString(), width, height, GIF_QUALITY, GIF_LOOP);
 }
 
@@ -30,11 +31,22 @@ bool GifEncoderWrapper::close()
     return result;
 }
 
-bool GifEncoderWrapper::push(const QImage& frame, int x, int y)
+// The changed rect is encoded from the frame itself, with the stride of the frame.
+bool GifEncoderWrapper::push(QImage& frame, int x, int y)
 {
     Q_ASSERT(mGifEncoder);
-    const uint8_t* frameBits = frame.constBits();
-    return mGifEncoder->push(frameBits, x, y, frame.width(), frame.height(), mFrameDuration);
+    QRect changedRect = mFrameDiffer.diff(frame, QPoint(x, y));
+
+    // A frame is needed for its duration, even if nothing changed.
+    if (changedRect.isEmpty())
+    {
+        changedRect = QRect(x, y, 1, 1);
+        *reinterpret_cast<uint32_t*>(frame.scanLine(0)) = FrameDiffer::UNCHANGED_PIXEL;
+    }
+
+    const uint8_t* frameBits = frame.constScanLine(changedRect.y() - y) + (changedRect.x() - x) * 4;
+    return mGifEncoder->push(frameBits, changedRect.x(), changedRect.y(), changedRect.width(), changedRect.height(),
+                             frame.bytesPerLine(), mFrameDuration);
 }
 
 }
@@ -1,6 +1,7 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #pragma once
+#include "frame_differ.h"
 #include "video_encoder_interface.h"
 #include "egif/GifEncoder.h"
 
@@ -11,13 +12,17 @@ class GifEncoderWrapper : public IVideoEncoder
 public:
     bool open(const QString& fileName, int width, int height, int fps, int bitsPerFrame) override;
     bool close() override;
-    bool push(const QImage& frame, int x, int y) override;
+    bool push(QImage& frame, int x, int y) override;
     QString getFileExtension() const override { return "gif"; }
     bool canEncodePartialFrame() const override { return true; }
 
 private:
     std::unique_ptr<GifEncoder> mGifEncoder;
     int mFrameDuration = 4;
+
+    // Only the changed pixels of a frame are encoded. The previous frames stay
+    // on screen and show through the transparent pixels.
+    FrameDiffer mFrameDiffer;
 };
 
 }
@@ -0,0 +1,64 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "line_history.h"
+#include <cmath>
+#include <limits>
+
+namespace SpiralFun {
+
+void LineHistory::clear()
+{
+    mBlocks.clear();
+    mSize = 0;
+}
+
+void LineHistory::append(const QPointF& point)
+{
+    const int32_t x = std::lround(point.x() * RESOLUTION);
+    const int32_t y = std::lround(point.y() * RESOLUTION);
+    const int32_t dx = x - mLastX;
+    const int32_t dy = y - mLastY;
+    constexpr int32_t MIN_DELTA = std::numeric_limits<int16_t>::min();
+    constexpr int32_t MAX_DELTA = std::numeric_limits<int16_t>::max();
+
+    if (mBlocks.empty() || mBlocks.back().mDeltas.size() >= (BLOCK_SIZE - 1) * 2 ||
+        dx < MIN_DELTA || dx > MAX_DELTA || dy < MIN_DELTA || dy > MAX_DELTA)
+    {
+        startBlock(x, y);
+    }
+    else
+    {
+        auto& deltas = mBlocks.back().mDeltas;
+        deltas.push_back(dx);
+        deltas.push_back(dy);
+    }
+
+    mLastX = x;
+    mLastY = y;
+    mLastPoint = point;
+    ++mSize;
+}
+
+void LineHistory::append(const QPointF* begin, const QPointF* end)
+{
+    for (const QPointF* p = begin; p != end; ++p)
+        append(*p);
+}
+
+void LineHistory::startBlock(int32_t x, int32_t y)
+{
+    mBlocks.push_back({ x, y, {} });
+    mBlocks.back().mDeltas.reserve(256);
+}
+
+std::size_t LineHistory::getMemoryUsage() const
+{
+    std::size_t bytes = mBlocks.capacity() * sizeof(Block);
+
+    for (const Block& block : mBlocks)
+        bytes += block.mDeltas.capacity() * sizeof(int16_t);
+
+    return bytes;
+}
+
+}
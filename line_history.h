@@ -0,0 +1,93 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QPointF>
+#include <cstdint>
+#include <vector>
+
+namespace SpiralFun {
+
+// Compact store of all points of a line, such that a finished curve can be
+// rendered or exported again without playing it.
+//
+// Points are quantized to 1/RESOLUTION pixel and stored as int16 deltas to the
+// previous point in blocks of at most BLOCK_SIZE points. Each block starts
+// with an absolute point. A delta that does not fit in int16 starts a new block.
+// As the deltas are between quantized points, the quantization error does not
+// accumulate.
+class LineHistory
+{
+public:
+    static constexpr qreal RESOLUTION = 64.0;
+    static constexpr unsigned BLOCK_SIZE = 4096;
+
+    void clear();
+    void append(const QPointF& point);
+    void append(const QPointF* begin, const QPointF* end);
+    bool empty() const { return mSize == 0; }
+    std::size_t size() const { return mSize; }
+    const QPointF& getLastPoint() const { return mLastPoint; }
+
+    // Bytes allocated for the points.
+    std::size_t getMemoryUsage() const;
+
+    // Call fun(const QPointF&) for all points in order.
+    template<typename Fun>
+    void forEach(Fun fun) const
+    {
+        forEachFrom(0, fun);
+    }
+
+    // Call fun(const QPointF&) for the points from index first in order. Blocks
+    // before the block of the first point are skipped without decoding them.
+    template<typename Fun>
+    void forEachFrom(std::size_t first, Fun fun) const
+    {
+        for (const Block& block : mBlocks)
+        {
+            const std::size_t blockSize = 1 + block.mDeltas.size() / 2;
+
+            if (first >= blockSize)
+            {
+                first -= blockSize;
+                continue;
+            }
+
+            int32_t x = block.mStartX;
+            int32_t y = block.mStartY;
+
+            if (first == 0)
+                fun(toPoint(x, y));
+
+            for (std::size_t i = 0; i < block.mDeltas.size(); i += 2)
+            {
+                x += block.mDeltas[i];
+                y += block.mDeltas[i + 1];
+
+                if (i / 2 + 1 >= first)
+                    fun(toPoint(x, y));
+            }
+
+            first = 0;
+        }
+    }
+
+private:
+    struct Block
+    {
+        int32_t mStartX;
+        int32_t mStartY;
+        std::vector<int16_t> mDeltas; // x, y pairs
+    };
+
+    static QPointF toPoint(int32_t x, int32_t y) { return QPointF(x / RESOLUTION, y / RESOLUTION); }
+    void startBlock(int32_t x, int32_t y);
+
+    std::vector<Block> mBlocks;
+    int32_t mLastX = 0;
+    int32_t mLastY = 0;
+    QPointF mLastPoint;
+    std::size_t mSize = 0;
+};
+
+}
@@ -0,0 +1,139 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "line_tessellator.h"
+#include <QtMath>
+#include <cmath>
+
+namespace SpiralFun {
+
+namespace {
+
+// Segments shorter than this have no reliable direction and are skipped.
+constexpr qreal MIN_SEGMENT_LENGTH = 1e-3;
+
+QPointF normal(const QPointF& dir)
+{
+    return QPointF(-dir.y(), dir.x());
+}
+
+}
+
+LineTessellator::LineTessellator(qreal width, Join join) :
+    mJoin(join)
+{
+    setWidth(width);
+}
+
+void LineTessellator::setWidth(qreal width)
+{
+    mHalfWidth = width / 2.0;
+
+    // Angle per triangle of a round join such that the chord stays within tolerance.
+    mRoundStep = mHalfWidth > ROUND_TOLERANCE ? 2.0 * std::acos(1.0 - ROUND_TOLERANCE / mHalfWidth) : M_PI;
+}
+
+void LineTessellator::reset()
+{
+    mHasPoint = false;
+    mHasDirection = false;
+    mLastLength = 0.0;
+}
+
+void LineTessellator::append(const QPointF* begin, const QPointF* end, std::vector<QPointF>& strip)
+{
+    const auto startSize = strip.size();
+
+    for (const QPointF* p = begin; p != end; ++p)
+    {
+        if (!mHasPoint)
+        {
+            mLastPoint = *p;
+            mHasPoint = true;
+            continue;
+        }
+
+        const QPointF v = *p - mLastPoint;
+        const qreal length = std::hypot(v.x(), v.y());
+
+        if (length < MIN_SEGMENT_LENGTH)
+            continue;
+
+        const QPointF dir = v / length;
+
+        if (mHasDirection)
+            addJoin(mLastPoint, mLastDirection, dir, std::min(mLastLength, length), strip.size() == startSize, strip);
+        else
+            addPair(mLastPoint, normal(dir) * mHalfWidth, strip);
+
+        mLastPoint = *p;
+        mLastDirection = dir;
+        mLastLength = length;
+        mHasDirection = true;
+    }
+
+    if (strip.size() != startSize)
+        addPair(mLastPoint, normal(mLastDirection) * mHalfWidth, strip);
+}
+
+void LineTessellator::addPair(const QPointF& p, const QPointF& offset, std::vector<QPointF>& strip) const
+{
+    strip.push_back(p + offset);
+    strip.push_back(p - offset);
+}
+
+void LineTessellator::addJoin(const QPointF& p, const QPointF& dirIn, const QPointF& dirOut, qreal minLength,
+                              bool startOfStrip, std::vector<QPointF>& strip) const
+{
+    const QPointF normalIn = normal(dirIn);
+    const QPointF normalOut = normal(dirOut);
+    const qreal cross = dirIn.x() * dirOut.y() - dirIn.y() * dirOut.x();
+    const qreal dot = QPointF::dotProduct(dirIn, dirOut);
+
+    if (mJoin == Join::MITER)
+    {
+        const QPointF m = normalIn + normalOut;
+        const qreal mLength = std::hypot(m.x(), m.y());
+        const qreal cosHalf = mLength / 2.0;
+
+        // The inner corner of a miter lies halfWidth * tan(half turn) back on
+        // both segments. It must not pass the other end of a short segment.
+        if (cosHalf * MITER_LIMIT >= 1.0 &&
+            mHalfWidth * std::sqrt(1.0 - cosHalf * cosHalf) <= minLength * cosHalf)
+        {
+            // Overlap the butt cap that ended the previous strip.
+            if (startOfStrip)
+                addPair(p, normalIn * mHalfWidth, strip);
+
+            addPair(p, m / mLength * (mHalfWidth / cosHalf), strip);
+            return;
+        }
+    }
+
+    addRoundJoin(p, normalIn, normalOut, cross, dot, strip);
+}
+
+// The join is a fan around p on the outer side of the turn. The inner side
+// is covered by the overlapping segments.
+void LineTessellator::addRoundJoin(const QPointF& p, const QPointF& normalIn, const QPointF& normalOut,
+                                   qreal cross, qreal dot, std::vector<QPointF>& strip) const
+{
+    const qreal angle = std::atan2(cross, dot);
+    const int steps = std::max(1, int(std::ceil(std::abs(angle) / mRoundStep)));
+    const qreal stepCos = std::cos(angle / steps);
+    const qreal stepSin = std::sin(angle / steps);
+    const bool outerLeft = cross <= 0.0;
+    QPointF v = normalIn * (outerLeft ? mHalfWidth : -mHalfWidth);
+
+    addPair(p, normalIn * mHalfWidth, strip);
+
+    for (int i = 0; i <= steps; ++i)
+    {
+        strip.push_back(outerLeft ? p + v : p);
+        strip.push_back(outerLeft ? p : p + v);
+        v = QPointF(v.x() * stepCos - v.y() * stepSin, v.x() * stepSin + v.y() * stepCos);
+    }
+
+    addPair(p, normalOut * mHalfWidth, strip);
+}
+
+}
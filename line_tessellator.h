@@ -0,0 +1,58 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QPointF>
+#include <vector>
+
+namespace SpiralFun {
+
+// Expands a polyline into a triangle strip of the line width, such that wide
+// lines do not depend on the line width support of the GL driver.
+//
+// Points are tessellated incrementally. Each call to append produces a strip
+// that starts at the last point of the previous call and ends with a butt cap
+// at the last new point. The next strip overlaps this cap with the join.
+class LineTessellator
+{
+public:
+    enum class Join { MITER, ROUND };
+
+    // The miter join is replaced by a round join when the miter would be longer
+    // than MITER_LIMIT times the half width.
+    static constexpr qreal MITER_LIMIT = 2.0;
+
+    // Maximum distance between a round join and its polygon approximation.
+    static constexpr qreal ROUND_TOLERANCE = 0.25;
+
+    explicit LineTessellator(qreal width = 1.0, Join join = Join::MITER);
+
+    void setWidth(qreal width);
+    qreal getWidth() const { return mHalfWidth * 2.0; }
+    void setJoin(Join join) { mJoin = join; }
+    Join getJoin() const { return mJoin; }
+
+    // Forget the line, the next point will start a new line.
+    void reset();
+
+    // Append points to the line. The triangle strip for the new segments is
+    // added to strip. Nothing is added if no new segment was formed.
+    void append(const QPointF* begin, const QPointF* end, std::vector<QPointF>& strip);
+
+private:
+    void addPair(const QPointF& p, const QPointF& offset, std::vector<QPointF>& strip) const;
+    void addJoin(const QPointF& p, const QPointF& dirIn, const QPointF& dirOut, qreal minLength,
+                 bool startOfStrip, std::vector<QPointF>& strip) const;
+    void addRoundJoin(const QPointF& p, const QPointF& normalIn, const QPointF& normalOut,
+                      qreal cross, qreal dot, std::vector<QPointF>& strip) const;
+
+    qreal mHalfWidth;
+    qreal mRoundStep;
+    Join mJoin;
+    QPointF mLastPoint;
+    QPointF mLastDirection;
+    qreal mLastLength = 0.0;
+    bool mHasPoint = false;
+    bool mHasDirection = false;
+};
+
+}
@@ -174,9 +174,9 @@ ApplicationWindow {
             }
             ProgressBar {
                 id: playProgressBar
-                value: scene.isRecording() ? scene.playAngle : scene.sequenceFrame
+                value: scene.isRecording() ? scene.playAngle : scene.sequenceFrame + scene.curveProgress
                 from: 0
-                to: scene.isRecording() ? Math.PI * 2 : scene.sequenceLength
+                to: scene.isRecording() ? scene.playEndAngle : scene.sequenceLength
                 anchors.bottom: parent.bottom
                 anchors.left: parent.left
                 anchors.right: parent.right
@@ -192,6 +192,21 @@ ApplicationWindow {
                     enabled: scene.donePlaying()
                     onTriggered: scene.saveImage()
                 }
+                MenuItem {
+                    text: "Save poster"
+                    enabled: scene.donePlaying()
+                    onTriggered: scene.savePoster(scene.POSTER_SIZE)
+                }
+                MenuItem {
+                    text: "Save SVG"
+                    enabled: scene.donePlaying()
+                    onTriggered: scene.saveVector(SpiralScene.VECTOR_SVG)
+                }
+                MenuItem {
+                    text: "Save PDF"
+                    enabled: scene.donePlaying()
+                    onTriggered: scene.saveVector(SpiralScene.VECTOR_PDF)
+                }
                 MenuItem {
                     text: "Load config"
                     enabled: scene.notPlaying()
@@ -1,7 +1,6 @@
 // Copyright (C) 2024 Michel de Boer
 // License: GPLv3
 #include "music_generator.h"
-#include "flash.h"
 #include "spiral_scene.h"
 #include <QAudioDevice>
 #include <QMediaDevices>
@@ -11,8 +10,8 @@ namespace SpiralFun {
 
 static const std::initializer_list<QString> NOTES = { "C", "Db", "D", "Eb", "E", "F", "Gb", "G", "Ab", "A", "Bb", "B" };
 
-MusicGenerator::MusicGenerator(const CircleList &circles, qreal toneDistance, int tonePlayInterval, SpiralScene* scene) :
-    mCircles(circles),
+MusicGenerator::MusicGenerator(SpiralEngine& engine, qreal toneDistance, int tonePlayInterval, SpiralScene* scene) :
+    mEngine(engine),
     mToneDistance(toneDistance),
     mTonePlayInterval(tonePlayInterval),
     mScene(scene)
@@ -39,27 +38,27 @@ void MusicGenerator::playNotes()
 {
     bool draw = false;
 
-    for (auto& circle : std::ranges::reverse_view(mCircles))
+    for (unsigned index : std::views::iota(0u, mEngine.size()) | std::views::reverse)
     {
-        if (!circle->getDraw())
+        if (!mEngine.getDraw(index))
             continue;
 
         // The first circle with draw enabled determines when to play tones.
-        if (!draw && circle->getDrawnLength() < mToneDistance && !mSounds[circle.get()].empty())
+        if (!draw && mEngine.getDrawnLength(index) < mToneDistance && !mSounds[index].empty())
             return;
 
         draw = true;
-        playNote(circle);
+        playNote(index);
     }
 }
 
-void MusicGenerator::playNote(const std::unique_ptr<SpiralFun::Circle>& circle)
+void MusicGenerator::playNote(unsigned index)
 {
     const qreal MAX_DISTANCE = SpiralScene::MAX_DIAMETER / 2.0;
-    QLineF line(mCircles[0]->getCenter(), circle->getCenter());
+    QLineF line(mEngine.getCenter(0), mEngine.getCenter(index));
     const auto distance = std::min(line.length(), MAX_DISTANCE);
     int noteIndex = std::min((int)(distance / mNoteSize), (int)mNotes.size() - 1);
-    auto& playing = mSounds[circle.get()];
+    auto& playing = mSounds[index];
 
     if (!playing.empty())
     {
@@ -84,9 +83,9 @@ void MusicGenerator::playNote(const std::unique_ptr<SpiralFun::Circle>& circle)
         playing.pop();
 
     qDebug() << "Play:" << newNote;
-    circle->setDrawnLength(0.0);
+    mEngine.setDrawnLength(index, 0.0);
 
-    new Flash(circle->getCenter(), circle->getColor(), mScene);
+    mScene->addFlash(mEngine.getCenter(index), mEngine.getColor(index));
 }
 
 }
@@ -2,7 +2,7 @@
 // License: GPLv3
 #pragma once
 
-#include "circle.h"
+#include "spiral_engine.h"
 #include <QSoundEffect>
 #include <QObject>
 #include <queue>
@@ -16,16 +16,16 @@ class MusicGenerator : public QObject
     Q_OBJECT
 
 public:
-    MusicGenerator(const CircleList &circles, qreal toneDistance, int tonePlayInterval, SpiralScene* scene);
+    MusicGenerator(SpiralEngine& engine, qreal toneDistance, int tonePlayInterval, SpiralScene* scene);
 
     int getTonePlayInterval() const { return mTonePlayInterval; }
     void playNotes();
 
 private:
     void initNotes();
-    void playNote(const std::unique_ptr<SpiralFun::Circle>& circle);
+    void playNote(unsigned index);
 
-    const CircleList& mCircles;
+    SpiralEngine& mEngine;
 
     struct Sound
     {
@@ -35,7 +35,7 @@ private:
 
     std::vector<QString> mNotes;
     qreal mNoteSize = 1.0;
-    std::unordered_map<Circle*, std::queue<Sound>> mSounds;
+    std::unordered_map<unsigned, std::queue<Sound>> mSounds;
     qreal mToneDistance = 25.0;
     int mTonePlayInterval = 1;
     SpiralScene* mScene;
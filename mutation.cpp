@@ -6,39 +6,35 @@
 
 namespace SpiralFun {
 
-void Mutation::init(const CircleList& circleList)
+void Mutation::init(const SpiralEngine& engine)
 {
-    auto& circle = circleList[getCircle()];
-    mRotationDeltaFactor = circle->getSpeed() < 0 ? -1 : 1;
+    mRotationDeltaFactor = engine.getSpeed(getCircle()) < 0 ? -1 : 1;
 }
 
-void Mutation::apply(const CircleList& circleList, int maxDiameter, bool reverse) const
+void Mutation::apply(SpiralEngine& engine, int maxDiameter, bool reverse) const
 {
-    auto& circle = circleList[getCircle()];
+    const unsigned circle = getCircle();
     const int changeFactor = reverse ? -1 : 1;
 
     switch (getTrait())
     {
     case Mutation::TRAIT_ROTATIONS: {
             const int delta = (getChange() == Mutation::CHANGE_INCREMENT ? 1 : -1) * mRotationDeltaFactor * changeFactor;
-            const int newSpeed = circle->getSpeed() + delta;
+            const int newSpeed = engine.getSpeed(circle) + delta;
             const int speed = std::clamp(newSpeed, -SpiralConfig::MAX_SPEED, SpiralConfig::MAX_SPEED);
-            circle->setSpeed(speed);
+            engine.setSpeed(circle, speed);
             break;
         }
     case Mutation::TRAIT_DIAMETER: {
             const int delta = (getChange() == Mutation::CHANGE_INCREMENT ? 1 : -1) * changeFactor;
-            const int newDiameter = circle->getDiameter() + delta;
+            const int newDiameter = engine.getDiameter(circle) + delta;
             const int diameter = std::clamp(newDiameter, 1, maxDiameter);
-            circle->setDiameter(diameter);
-            break;
-        }
-    case Mutation::TRAIT_DIRECTION: {
-            const Circle::Direction direction = circle->getDirection() == Circle::CLOCKWISE ?
-                        Circle::COUNTER_CLOCKWISE : Circle::CLOCKWISE;
-            circle->setDirection(direction);
+            engine.setDiameter(circle, diameter);
             break;
         }
+    case Mutation::TRAIT_DIRECTION:
+        engine.setSpeed(circle, -engine.getSpeed(circle));
+        break;
     }
 }
 
@@ -2,7 +2,7 @@
 // License: GPLv3
 #pragma once
 
-#include "circle.h"
+#include "spiral_engine.h"
 #include <qqml.h>
 #include <QObject>
 
@@ -31,8 +31,8 @@ public:
     void setTrait(Trait trait) { mTrait = trait; emit traitChanged(); }
     void setChange(Change change) { mChange = change; emit changeChanged(); }
 
-    void init(const CircleList& circleList);
-    void apply(const CircleList& circleList, int maxDiameter, bool reverse = false) const;
+    void init(const SpiralEngine& engine);
+    void apply(SpiralEngine& engine, int maxDiameter, bool reverse = false) const;
 
 signals:
     void circleChanged();
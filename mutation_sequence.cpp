@@ -11,22 +11,22 @@ bool MutationSequence::isVideoType(SaveAs saveAs)
     return saveAs == SAVE_AS_GIF || saveAs == SAVE_AS_VIDEO;
 }
 
-MutationSequence::MutationSequence(const CircleList* circles, ISequencePlayer* sequencePlayer) :
+MutationSequence::MutationSequence(SpiralEngine* engine, ISequencePlayer* sequencePlayer) :
     QObject(),
-    mCircles(circles),
+    mEngine(engine),
     mSequencePlayer(sequencePlayer)
 {
 }
 
 MutationSequence::~MutationSequence()
 {
-    if (mCircles && mOrigCircleSettings.size() == mCircles->size())
+    if (mEngine && mOrigCircleSettings.size() == mEngine->size())
         restoreCircleSettings();
 }
 
 void MutationSequence::setMutations(const QVariant& mutationsQmlList)
 {
-    Q_ASSERT(mCircles);
+    Q_ASSERT(mEngine);
     const auto mutationList = mutationsQmlList.value<QQmlListReference>();
     mMutations.clear();
     mMutations.reserve(mutationList.size());
@@ -34,7 +34,7 @@ void MutationSequence::setMutations(const QVariant& mutationsQmlList)
     for (int i = 0; i < mutationList.size(); ++i)
     {
         Mutation* mutation = dynamic_cast<Mutation*>(mutationList.at(i));
-        mutation->init(*mCircles);
+        mutation->init(*mEngine);
         mMutations.push_back(mutation);
     }
 }
@@ -74,13 +74,13 @@ void MutationSequence::backupCircleSettings()
 {
 
     mOrigCircleSettings.clear();
-    mOrigCircleSettings.reserve(mCircles->size());
+    mOrigCircleSettings.reserve(mEngine->size());
 
-    for (const auto& c : *mCircles)
+    for (unsigned i = 0; i < mEngine->size(); ++i)
     {
         CircleTraits traits;
-        traits.mDiameter = c->getDiameter();
-        traits.mSpeed = c->getSpeed();
+        traits.mDiameter = mEngine->getDiameter(i);
+        traits.mSpeed = mEngine->getSpeed(i);
         mOrigCircleSettings.push_back(traits);
     }
 
@@ -89,14 +89,13 @@ void MutationSequence::backupCircleSettings()
 
 void MutationSequence::restoreCircleSettings()
 {
-    Q_ASSERT(mCircles);
-    Q_ASSERT(mOrigCircleSettings.size() == mCircles->size());
+    Q_ASSERT(mEngine);
+    Q_ASSERT(mOrigCircleSettings.size() == mEngine->size());
     for (unsigned i = 0; i < mOrigCircleSettings.size(); ++i)
     {
-        auto& c = (*mCircles)[i];
         const auto& traits = mOrigCircleSettings[i];
-        c->setDiameter(traits.mDiameter);
-        c->setSpeed(traits.mSpeed);
+        mEngine->setDiameter(i, traits.mDiameter);
+        mEngine->setSpeed(i, traits.mSpeed);
     }
 
     mOrigCircleSettings.clear();
@@ -152,12 +151,12 @@ void MutationSequence::playNextFrame()
 
 void MutationSequence::playMutation(unsigned index, bool reverse)
 {
-    Q_ASSERT(mCircles);
+    Q_ASSERT(mEngine);
     Q_ASSERT(mSequencePlayer);
     Q_ASSERT(index < mMutations.size());
     const auto* mutation = mMutations[index];
     qDebug() << mutation->getCircle() << mutation->getTrait() << mutation->getChange();
-    mutation->apply(*mCircles, mSequencePlayer->getMaxDiameter(), reverse);
+    mutation->apply(*mEngine, mSequencePlayer->getMaxDiameter(), reverse);
     emit sequenceFramePlaying(mCurrentSequenceFrame);
     mSequencePlayer->playSequenceFrame();
 }
@@ -2,10 +2,10 @@
 // License: GPLv3
 #pragma once
 
-#include "circle.h"
 #include "recorder.h"
 #include "mutation.h"
 #include "scene_grabber.h"
+#include "spiral_engine.h"
 #include <QVariant>
 #include <vector>
 
@@ -39,10 +39,10 @@ public:
     static bool isVideoType(SaveAs saveAs);
 
     MutationSequence() = default; // Needed for QML_ELEMENT
-    MutationSequence(const CircleList* circles, ISequencePlayer* sequencePlayer);
+    MutationSequence(SpiralEngine* engine, ISequencePlayer* sequencePlayer);
     ~MutationSequence();
 
-    void setCircles(const CircleList* circles) { mCircles = circles; }
+    void setEngine(SpiralEngine* engine) { mEngine = engine; }
     void setSequencePlayer(ISequencePlayer* sequencePlayer) { mSequencePlayer = sequencePlayer; }
     void setSequenceLength(int sequenceLength) { mSequenceLength = sequenceLength; }
     void setAddReverseSequence(int addReverse) { mAddReverseSequence = addReverse; }
@@ -82,7 +82,7 @@ private:
     Recorder::FrameRate mFrameRate = Recorder::FPS_10;
     bool mAddReverseSequence = false;
     QString mPicturesSubDir;
-    const CircleList* mCircles = nullptr;
+    SpiralEngine* mEngine = nullptr;
     ISequencePlayer* mSequencePlayer = nullptr;
     std::unique_ptr<Recorder> mRecorder;
     QRectF mMaxSceneRect;
@@ -0,0 +1,70 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "pdf_exporter.h"
+#include "exception.h"
+#include <QFile>
+#include <QPageSize>
+
+namespace SpiralFun {
+
+PdfExporter::~PdfExporter()
+{
+    // A painter that is still active did not complete the file.
+    if (mPainter.isActive())
+    {
+        mPainter.end();
+        QFile::remove(mFileName);
+    }
+}
+
+void PdfExporter::open(const QString& fileName, const QRectF& sceneRect, const QColor& background)
+{
+    Q_ASSERT(!mPainter.isActive());
+    mFileName = fileName;
+    mWriter = std::make_unique<QPdfWriter>(fileName);
+    mWriter->setResolution(72);
+    mWriter->setPageSize(QPageSize(sceneRect.size(), QPageSize::Point, {}, QPageSize::ExactMatch));
+    mWriter->setPageMargins(QMarginsF(0, 0, 0, 0));
+
+    if (!mPainter.begin(mWriter.get()))
+        throw RuntimeException(QString("Failed to create: %1").arg(fileName));
+
+    mPainter.setRenderHint(QPainter::Antialiasing);
+    mPainter.fillRect(QRectF(QPointF(0, 0), sceneRect.size()), background);
+    mPainter.translate(-sceneRect.topLeft());
+}
+
+void PdfExporter::close()
+{
+    if (!mPainter.end())
+        throw RuntimeException(QString("Failed to write: %1").arg(mFileName));
+
+    mWriter = nullptr;
+}
+
+void PdfExporter::writeLineStart(const QColor& color, qreal width)
+{
+    mPainter.setPen(QPen(color, width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    mHasLastPoint = false;
+}
+
+void PdfExporter::writeLinePoints(const std::vector<QPointF>& points)
+{
+    // Continue from the last point of the previous batch.
+    mPolyline.clear();
+
+    if (mHasLastPoint)
+        mPolyline.push_back(mLastPoint);
+
+    mPolyline.insert(mPolyline.end(), points.begin(), points.end());
+    mPainter.drawPolyline(mPolyline.data(), mPolyline.size());
+    mLastPoint = points.back();
+    mHasLastPoint = true;
+}
+
+void PdfExporter::writeLineEnd()
+{
+    mHasLastPoint = false;
+}
+
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "vector_exporter.h"
+#include <QPainter>
+#include <QPdfWriter>
+#include <memory>
+
+namespace SpiralFun {
+
+// A single page PDF with 1 point per scene unit. The points of a line are drawn
+// as polylines per batch, connected with round caps and joins.
+class PdfExporter : public VectorExporter
+{
+public:
+    ~PdfExporter();
+
+    void open(const QString& fileName, const QRectF& sceneRect, const QColor& background) override;
+    void close() override;
+
+protected:
+    void writeLineStart(const QColor& color, qreal width) override;
+    void writeLinePoints(const std::vector<QPointF>& points) override;
+    void writeLineEnd() override;
+
+private:
+    QString mFileName;
+    std::unique_ptr<QPdfWriter> mWriter;
+    QPainter mPainter;
+    std::vector<QPointF> mPolyline;
+    QPointF mLastPoint;
+    bool mHasLastPoint = false;
+};
+
+}
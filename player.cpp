@@ -1,6 +1,8 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #include "player.h"
+#include <QElapsedTimer>
+#include <QScreen>
 #include <QTime>
 #include <chrono>
 
@@ -8,14 +10,36 @@ using namespace std::chrono_literals;
 
 namespace SpiralFun {
 
-Player::Player(const CircleList &circles, std::unique_ptr<MusicGenerator> musicGenerator) :
-    mCircles(circles),
+namespace {
+// Part of a frame interval used for play steps. The rest is left for rendering.
+constexpr qreal FRAME_STEP_FRACTION = 0.5;
+
+constexpr qreal DEFAULT_REFRESH_RATE = 60.0;
+
+// Frame interval to step with while the window does not render frames.
+constexpr auto HIDDEN_FRAME_INTERVAL = 16ms;
+
+// Weight of the last frame in the average step time.
+constexpr qreal STEP_TIME_WEIGHT = 0.1;
+}
+
+Player::Player(SpiralEngine& engine, std::unique_ptr<MusicGenerator> musicGenerator) :
+    mEngine(engine),
     mMusicGenerator(std::move(musicGenerator))
 {   
     mPlayTimer.setInterval(mMusicGenerator ? mMusicGenerator->getTonePlayInterval() : 0);
     QObject::connect(&mPlayTimer, &QTimer::timeout, this, &Player::advance);
+    mHiddenFrameTimer.setInterval(HIDDEN_FRAME_INTERVAL);
+    QObject::connect(&mHiddenFrameTimer, &QTimer::timeout, this, [this]{
+            // When the window is exposed, its frames drive the steps.
+            if (!mFrameWindow || !mFrameWindow->isExposed())
+                advanceFrame();
+        });
     mSceneRefreshTimer.setInterval(40ms);
-    QObject::connect(&mSceneRefreshTimer, &QTimer::timeout, this, [this]{ emit refreshScene(); });
+    QObject::connect(&mSceneRefreshTimer, &QTimer::timeout, this, [this]{
+            syncView();
+            emit refreshScene();
+        });
 }
 
 Player::~Player()
@@ -25,12 +49,7 @@ Player::~Player()
 
 bool Player::play(std::unique_ptr<Recorder> recorder)
 {
-    for (auto& circle : mCircles)
-        circle->preparePlay();
-
-    mStepsPerInterval = 1;
-    mStartTime = QTime::currentTime().msecsSinceStartOfDay();
-    mCycles = 0;
+    preparePlay();
     mRecorder = std::move(recorder);
     startTimers();
 
@@ -45,53 +64,151 @@ bool Player::play(std::unique_ptr<Recorder> recorder)
 
 void Player::playAll()
 {
-    for (auto& circle : mCircles)
-        circle->preparePlay();
+    preparePlay();
+    mCurveGenerator = std::make_unique<CurveGenerator>(mEngine);
+    QObject::connect(mCurveGenerator.get(), &CurveGenerator::progress, this, [this](qreal fraction){ emit progress(fraction); });
+    QObject::connect(mCurveGenerator.get(), &CurveGenerator::done, this, [this]{
+            mCycles = mCurveGenerator->getChunkCount();
+            mAngle = mEndAngle;
+            emit angleChanged();
+            finishPlaying();
+        });
+
+    mCurveGenerator->start(0.0, mEndAngle, mStepAngle);
+}
 
-    mStepsPerInterval = 100;
+void Player::preparePlay()
+{
+    mEngine.preparePlay(mStepAngle, mStepMode);
+    mEndAngle = mEngine.getPeriod();
+    qDebug() << "Play end angle:" << qRadiansToDegrees(mEndAngle);
     mStartTime = QTime::currentTime().msecsSinceStartOfDay();
     mCycles = 0;
-    mPlayTimer.start();
+}
+
+void Player::setFrameWindow(QQuickWindow* window)
+{
+    Q_ASSERT(window);
+
+    if (mMusicGenerator)
+        return;
+
+    mFrameWindow = window;
+
+    // The signal comes from the render thread. The steps are done on the GUI thread.
+    QObject::connect(window, &QQuickWindow::frameSwapped, this, [this]{ advanceFrame(); }, Qt::QueuedConnection);
 }
 
 void Player::startTimers()
 {
+    if (mFrameWindow)
+    {
+        // The first steps are done after the next frame. A window that is not
+        // exposed, e.g. minimized or with the screen off, swaps no frames. Then
+        // the timer does the steps, such that play and recording continue.
+        mFramePacing = true;
+        mStepsPaused = false;
+        mHiddenFrameTimer.start();
+        emit refreshScene();
+        return;
+    }
+
     mPlayTimer.start();
     mSceneRefreshTimer.start();
 }
 
 void Player::stopTimers()
 {
+    mFramePacing = false;
+    mHiddenFrameTimer.stop();
     mPlayTimer.stop();
     mSceneRefreshTimer.stop();
 }
 
-void Player::advance()
+void Player::pauseSteps()
 {
-    ++mCycles;
-    for (unsigned step = 0.0; step < mStepsPerInterval; ++step)
+    if (mFramePacing)
+        mStepsPaused = true;
+    else
+        mPlayTimer.stop();
+}
+
+void Player::resumeSteps()
+{
+    if (!mFramePacing)
     {
-        advanceCircles(mStepAngle);
-        mAngle += mStepAngle;
-        emit angleChanged();
+        mPlayTimer.start();
+        return;
+    }
 
-        if (mAngle >= M_PI * 2)
-        {
-            finishPlaying();
-            break;
-        }
+    mStepsPaused = false;
+    emit refreshScene();
+}
 
-        if (mRecording)
-        {
-            if (!record())
-                recordingFailed();
-        }
+// Called after each frame. The steps are done right after a frame, such that the
+// next frame shows them as soon as possible.
+void Player::advanceFrame()
+{
+    if (!mFramePacing || mStepsPaused)
+        return;
+
+    const qreal budget = getFrameBudget();
+    QElapsedTimer timer;
+    timer.start();
+    int steps = 0;
+
+    do
+    {
+        advance();
+        ++steps;
+    } while (mFramePacing && !mStepsPaused && timer.nsecsElapsed() / 1e6 + mStepTime <= budget);
+
+    const qreal stepTime = timer.nsecsElapsed() / 1e6 / steps;
+    mStepTime = mStepTime > 0.0 ? mStepTime + STEP_TIME_WEIGHT * (stepTime - mStepTime) : stepTime;
+
+    if (!mFramePacing)
+        return;
+
+    // Updating the scene makes the window render the next frame.
+    syncView();
+    emit refreshScene();
+}
+
+qreal Player::getFrameBudget() const
+{
+    const QScreen* screen = mFrameWindow ? mFrameWindow->screen() : nullptr;
+    const qreal refreshRate = screen && screen->refreshRate() > 0.0 ? screen->refreshRate() : DEFAULT_REFRESH_RATE;
+    return FRAME_STEP_FRACTION * 1000.0 / refreshRate;
+}
+
+void Player::advance()
+{
+    ++mCycles;
+    mEngine.advance(mAngle, mAngle + mStepAngle);
+    mAngle += mStepAngle;
+
+    if (mAngle >= mEndAngle)
+    {
+        finishPlaying();
+    }
+    else if (mRecording)
+    {
+        if (!record())
+            recordingFailed();
     }
 
     if (mMusicGenerator)
         mMusicGenerator->playNotes();
 }
 
+// The circles and the angle are shown at the scene refresh rate. The positions
+// between refreshes are only known to the engine.
+void Player::syncView()
+{
+    emit circlesMoved();
+    emit angleChanged();
+}
+
 void Player::recordingFailed()
 {
     stopTimers();
@@ -112,10 +229,11 @@ void Player::finishPlaying()
     Stats stats;
     stats.mCycles = mCycles;
     stats.mPlayTime = std::lround(t * 1000) * 1ms;
+    const unsigned symmetry = mCurveGenerator ? mCurveGenerator->getSymmetry() : 1;
+    stats.mSkippedFraction = 1.0 - mEndAngle / symmetry / (M_PI * 2);
 
-    // Draw the last line to close the curve. It may not have been drawn yet
-    // due to the minimum draw length.
-    forceDraw();
+    mEngine.forceDraw();
+    syncView();
     emit refreshScene();
 
     if (mRecording)
@@ -123,18 +241,20 @@ void Player::finishPlaying()
         // Record last frame
         updateRecordingRect();
 
-        const bool frameAdded = mRecorder->addFrame(mRecordingRect, [this, stats](bool frameAdded){
+        const bool frameAdded = mRecorder->addFrame(mRecordingRect, [this, stats](bool frameAdded) mutable {
             if (!frameAdded)
                 qWarning() << "Adding last frame failed";
 
             mRecorder->stopRecording(true);
-                emit done(stats);
+            stats.mRecorderStats = mRecorder->getStats();
+            emit done(stats);
             });
 
         if (!frameAdded)
         {
             qWarning() << "Failed to add last frame";
             mRecorder->stopRecording(true);
+            stats.mRecorderStats = mRecorder->getStats();
             emit done(stats);
         }
     }
@@ -144,38 +264,6 @@ void Player::finishPlaying()
     }
 }
 
-void Player::advanceCircles(qreal angle)
-{
-    for(unsigned i = 1; i < mCircles.size(); ++i)
-        advanceCircle(i, angle);
-}
-
-void Player::advanceCircle(unsigned index, qreal angle)
-{
-    if (index < 1 || index >= mCircles.size())
-        throw std::out_of_range(std::string("index=") + std::to_string(index));
-
-    const QPointF& rotationCenter = mCircles[index - 1]->getCenter();
-    const int speed = mCircles[index]->getSpeed();
-    const bool clockwise = speed > 0;
-
-    for (unsigned i = index; i < mCircles.size(); ++i)
-    {
-        auto& circle = *mCircles[i];
-        for (int n = 0; n < std::abs(speed); ++n)
-            circle.rotate(rotationCenter, angle, clockwise);
-    }
-}
-
-void Player::forceDraw()
-{
-    for (auto& circle : mCircles)
-    {
-        if (circle->getDraw())
-            circle->forceDrawToCenter();
-    }
-}
-
 bool Player::setupRecording()
 {
     Q_ASSERT(mRecorder);
@@ -194,12 +282,12 @@ bool Player::setupRecording()
 
 void Player::resetRecordingRect()
 {
-    mRecordingRect = mRecorder->calcBoundingRectangle(mCircles) & mFullFrameRect;
+    mRecordingRect = mRecorder->calcBoundingRectangle(mEngine) & mFullFrameRect;
 }
 
 void Player::updateRecordingRect()
 {
-    mRecordingRect |= mRecorder->calcBoundingRectangle(mCircles) & mFullFrameRect;
+    mRecordingRect |= mRecorder->calcBoundingRectangle(mEngine) & mFullFrameRect;
 }
 
 bool Player::record()
@@ -211,6 +299,7 @@ bool Player::record()
         return true;
 
     mRecordAngle = 0.0;
+    syncView();
     const bool frameAdded = mRecorder->addFrame(mRecordingRect, [this](bool frameAdded){
         if (!frameAdded)
         {
@@ -219,7 +308,7 @@ bool Player::record()
             return;
         }
 
-        mPlayTimer.start();
+        resumeSteps();
     });
 
     if (!frameAdded)
@@ -229,7 +318,7 @@ bool Player::record()
     }
 
     resetRecordingRect();
-    mPlayTimer.stop();
+    pauseSteps();
     return true;
 }
 
@@ -2,9 +2,12 @@
 // License: GPLv3
 #pragma once
 
-#include "circle.h"
+#include "curve_generator.h"
 #include "music_generator.h"
 #include "recorder.h"
+#include "spiral_engine.h"
+#include <QPointer>
+#include <QQuickWindow>
 #include <QTimer>
 
 namespace SpiralFun {
@@ -21,28 +24,52 @@ public:
         int mCycles = 0;
         std::chrono::milliseconds mPlayTime = 0ms;
         bool mRecordingFailed = false;
+
+        // Part of the full rotation of circle 1 that was not needed as the
+        // curves were closed already.
+        qreal mSkippedFraction = 0.0;
+
+        Recorder::Stats mRecorderStats;
     };
 
-    Player(const CircleList &circles, std::unique_ptr<MusicGenerator> musicGenerator);
+    Player(SpiralEngine& engine, std::unique_ptr<MusicGenerator> musicGenerator);
     ~Player();
 
     bool play(std::unique_ptr<Recorder> recorder = nullptr);
+
+    // Generate the complete curves on a thread pool without showing the circles move.
     void playAll();
+
+    // Pace play by the frames of the window instead of timers. Each frame
+    // advances as many steps as fit in a part of the frame interval, based on
+    // the measured step time. While the window is not exposed, a timer takes
+    // the place of the frames. Must be set before play. Not used with music,
+    // as the tone interval sets the pace then.
+    void setFrameWindow(QQuickWindow* window);
     qreal getAngle() const { return mAngle; }
+    qreal getEndAngle() const { return mEndAngle; }
+
+    // The step mode for play. Play-all always uses adaptive sampling.
+    void setStepMode(SpiralEngine::StepMode stepMode) { mStepMode = stepMode; }
     const QString& getFileName() const { return mRecorder->getFileName(); }
 
 signals:
     void done(Player::Stats stats);
     void refreshScene();
+    void circlesMoved();
     void angleChanged();
+    void progress(qreal fraction);
 
 private:
     void startTimers();
     void stopTimers();
+    void pauseSteps();
+    void resumeSteps();
+    void preparePlay();
     void advance();
-    void advanceCircles(qreal angle);
-    void advanceCircle(unsigned index, qreal angle);
-    void forceDraw();
+    void advanceFrame();
+    qreal getFrameBudget() const;
+    void syncView();
     void recordingFailed();
     void finishPlaying();
     bool setupRecording();
@@ -50,12 +77,13 @@ private:
     void updateRecordingRect();
     bool record();
 
-    const CircleList& mCircles;
+    SpiralEngine& mEngine;
     QTimer mPlayTimer;
     QTimer mSceneRefreshTimer;
     qreal mAngle = 0.0;
+    qreal mEndAngle = M_PI * 2;
     const qreal mStepAngle = qDegreesToRadians(0.05);
-    unsigned mStepsPerInterval = 1;
+    SpiralEngine::StepMode mStepMode = SpiralEngine::StepMode::ADAPTIVE;
     const qreal mRecordAngleThreshold = qDegreesToRadians(1);
     qreal mRecordAngle = 0.0;
     int mStartTime;
@@ -65,6 +93,12 @@ private:
     std::unique_ptr<Recorder> mRecorder;
     bool mRecording = false;
     std::unique_ptr<MusicGenerator> mMusicGenerator;
+    std::unique_ptr<CurveGenerator> mCurveGenerator;
+    QPointer<QQuickWindow> mFrameWindow;
+    QTimer mHiddenFrameTimer;
+    bool mFramePacing = false;
+    bool mStepsPaused = false;
+    qreal mStepTime = 0.0; // ms, moving average
 };
 
 }
@@ -0,0 +1,153 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "png_writer.h"
+#include "exception.h"
+#include <QtEndian>
+
+namespace SpiralFun {
+
+namespace {
+
+constexpr uchar PNG_SIGNATURE[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+constexpr uchar COLOR_TYPE_RGB = 2;
+constexpr uchar FILTER_SUB = 1;
+
+// Size of the IDAT chunks
+constexpr std::size_t OUTPUT_SIZE = 64 * 1024;
+
+}
+
+PngWriter::~PngWriter()
+{
+    endStream();
+
+    // A file that is still open was not completed.
+    if (mFile.isOpen())
+    {
+        mFile.close();
+        mFile.remove();
+    }
+}
+
+void PngWriter::open(const QString& fileName, const QSize& size)
+{
+    Q_ASSERT(!mFile.isOpen());
+    mFile.setFileName(fileName);
+
+    if (!mFile.open(QIODevice::WriteOnly))
+        throw RuntimeException(QString("Failed to create: %1").arg(fileName));
+
+    mSize = size;
+    mRowCount = 0;
+    write(PNG_SIGNATURE, sizeof(PNG_SIGNATURE));
+
+    uchar header[13];
+    qToBigEndian<quint32>(size.width(), header);
+    qToBigEndian<quint32>(size.height(), header + 4);
+    header[8] = 8; // bits per channel
+    header[9] = COLOR_TYPE_RGB;
+    header[10] = 0; // deflate
+    header[11] = 0; // adaptive filtering
+    header[12] = 0; // no interlace
+    writeChunk("IHDR", header, sizeof(header));
+
+    mStream = {};
+
+    if (deflateInit(&mStream, Z_DEFAULT_COMPRESSION) != Z_OK)
+        throw RuntimeException("Failed to initialize PNG compression.");
+
+    mStreamOpen = true;
+    mRow.resize(1 + std::size_t(size.width()) * 3);
+    mOutput.resize(OUTPUT_SIZE);
+}
+
+// The sub filter stores the difference with the pixel to the left, which
+// compresses the smooth edges of anti-aliased lines well.
+void PngWriter::writeRow(const uchar* rgb)
+{
+    Q_ASSERT(mStreamOpen);
+    Q_ASSERT(mRowCount < mSize.height());
+    const std::size_t rowSize = mRow.size() - 1;
+    mRow[0] = FILTER_SUB;
+    std::copy(rgb, rgb + 3, mRow.data() + 1);
+
+    for (std::size_t i = 3; i < rowSize; ++i)
+        mRow[i + 1] = rgb[i] - rgb[i - 3];
+
+    mStream.next_in = mRow.data();
+    mStream.avail_in = mRow.size();
+    deflateData(Z_NO_FLUSH);
+    ++mRowCount;
+}
+
+void PngWriter::close()
+{
+    if (mRowCount != mSize.height())
+        throw RuntimeException(QString("PNG has %1 of %2 rows").arg(mRowCount).arg(mSize.height()));
+
+    deflateData(Z_FINISH);
+    endStream();
+    writeChunk("IEND", nullptr, 0);
+    mFile.close();
+
+    if (mFile.error() != QFileDevice::NoError)
+        throw RuntimeException(QString("Failed to write: %1").arg(mFile.fileName()));
+}
+
+void PngWriter::deflateData(int flush)
+{
+    int result;
+
+    do
+    {
+        mStream.next_out = mOutput.data();
+        mStream.avail_out = mOutput.size();
+        result = deflate(&mStream, flush);
+
+        if (result == Z_STREAM_ERROR)
+            throw RuntimeException("PNG compression failed.");
+
+        const std::size_t produced = mOutput.size() - mStream.avail_out;
+
+        if (produced > 0)
+            writeChunk("IDAT", mOutput.data(), produced);
+    }
+    while (mStream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+}
+
+void PngWriter::writeChunk(const char* type, const uchar* data, std::size_t size)
+{
+    uchar length[4];
+    qToBigEndian<quint32>(size, length);
+    write(length, 4);
+    write(type, 4);
+
+    uLong crc = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+
+    if (size > 0)
+    {
+        write(data, size);
+        crc = crc32(crc, data, size);
+    }
+
+    uchar crcBytes[4];
+    qToBigEndian<quint32>(crc, crcBytes);
+    write(crcBytes, 4);
+}
+
+void PngWriter::write(const void* data, std::size_t size)
+{
+    if (mFile.write(static_cast<const char*>(data), size) != qint64(size))
+        throw RuntimeException(QString("Failed to write: %1").arg(mFile.fileName()));
+}
+
+void PngWriter::endStream()
+{
+    if (mStreamOpen)
+    {
+        deflateEnd(&mStream);
+        mStreamOpen = false;
+    }
+}
+
+}
@@ -0,0 +1,41 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QFile>
+#include <QSize>
+#include <vector>
+#include <zlib.h>
+
+namespace SpiralFun {
+
+// Writes an 8 bit RGB PNG file row by row, such that the image never has to be
+// in memory as a whole. Errors throw RuntimeException.
+class PngWriter
+{
+public:
+    ~PngWriter();
+
+    void open(const QString& fileName, const QSize& size);
+
+    // Add the next row of width * 3 bytes R, G, B.
+    void writeRow(const uchar* rgb);
+
+    // Write the remaining data. All rows must have been written.
+    void close();
+
+private:
+    void deflateData(int flush);
+    void writeChunk(const char* type, const uchar* data, std::size_t size);
+    void write(const void* data, std::size_t size);
+    void endStream();
+
+    QFile mFile;
+    QSize mSize;
+    int mRowCount = 0;
+    z_stream mStream;
+    bool mStreamOpen = false;
+    std::vector<uchar> mRow;
+    std::vector<uchar> mOutput;
+};
+
+}
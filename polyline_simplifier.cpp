@@ -0,0 +1,101 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "polyline_simplifier.h"
+#include <QtMath>
+#include <cmath>
+
+namespace SpiralFun {
+
+PolylineSimplifier::PolylineSimplifier(qreal tolerance)
+{
+    setTolerance(tolerance);
+}
+
+void PolylineSimplifier::setTolerance(qreal tolerance)
+{
+    mTolerance = tolerance;
+    mConeTolerance = tolerance * M_SQRT1_2;
+}
+
+void PolylineSimplifier::reset()
+{
+    mHasAnchor = false;
+    mHasLastPoint = false;
+}
+
+void PolylineSimplifier::add(const QPointF& p, std::vector<QPointF>& out)
+{
+    if (!mHasAnchor)
+    {
+        out.push_back(p);
+        startCone(p);
+        mHasAnchor = true;
+        return;
+    }
+
+    if (!extendCone(p))
+    {
+        out.push_back(mLastPoint);
+        startCone(mLastPoint);
+        extendCone(p);
+    }
+
+    mLastPoint = p;
+    mHasLastPoint = true;
+}
+
+void PolylineSimplifier::finish(std::vector<QPointF>& out)
+{
+    if (mHasLastPoint)
+        out.push_back(mLastPoint);
+
+    reset();
+}
+
+void PolylineSimplifier::startCone(const QPointF& anchor)
+{
+    mAnchor = anchor;
+    mHasReference = false;
+    mMaxDistance = 0.0;
+}
+
+bool PolylineSimplifier::extendCone(const QPointF& p)
+{
+    const QPointF v = p - mAnchor;
+    const qreal distance = std::hypot(v.x(), v.y());
+
+    // A point that goes back would be beyond the end of the segment.
+    if (distance < mMaxDistance - mConeTolerance)
+        return false;
+
+    if (distance <= mConeTolerance)
+    {
+        mMaxDistance = std::max(mMaxDistance, distance);
+        return true;
+    }
+
+    const qreal halfAngle = std::asin(mConeTolerance / distance);
+
+    if (!mHasReference)
+    {
+        mReference = v / distance;
+        mHasReference = true;
+        mMinAngle = -halfAngle;
+        mMaxAngle = halfAngle;
+        mMaxDistance = std::max(mMaxDistance, distance);
+        return true;
+    }
+
+    const qreal cross = mReference.x() * v.y() - mReference.y() * v.x();
+    const qreal angle = std::atan2(cross, QPointF::dotProduct(mReference, v));
+
+    if (angle < mMinAngle || angle > mMaxAngle)
+        return false;
+
+    mMinAngle = std::max(mMinAngle, angle - halfAngle);
+    mMaxAngle = std::min(mMaxAngle, angle + halfAngle);
+    mMaxDistance = std::max(mMaxDistance, distance);
+    return true;
+}
+
+}
@@ -0,0 +1,57 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QPointF>
+#include <vector>
+
+namespace SpiralFun {
+
+// Removes points from a polyline while it is streamed, such that every removed
+// point is within the tolerance of the simplified polyline.
+//
+// From the last kept point (the anchor) each next point allows a cone of
+// directions for a segment that passes it within the tolerance. The cones are
+// intersected. When a point falls outside the intersection, the previous point
+// is kept and becomes the new anchor. The cost is constant per point.
+class PolylineSimplifier
+{
+public:
+    explicit PolylineSimplifier(qreal tolerance = 0.05);
+
+    void setTolerance(qreal tolerance);
+    qreal getTolerance() const { return mTolerance; }
+
+    // Start a new polyline.
+    void reset();
+
+    // Add the next point. Points that are kept are appended to out.
+    void add(const QPointF& p, std::vector<QPointF>& out);
+
+    // End the polyline. The last point is appended to out.
+    void finish(std::vector<QPointF>& out);
+
+private:
+    bool extendCone(const QPointF& p);
+    void startCone(const QPointF& anchor);
+
+    qreal mTolerance;
+
+    // A point within the cone and the distance limit is within mConeTolerance
+    // from the ray and mConeTolerance from the segment end. mConeTolerance is
+    // such that the combined distance is within mTolerance.
+    qreal mConeTolerance;
+
+    QPointF mAnchor;
+    QPointF mLastPoint;
+    bool mHasAnchor = false;
+    bool mHasLastPoint = false;
+
+    // Allowed directions in radians relative to mReference
+    QPointF mReference;
+    bool mHasReference = false;
+    qreal mMinAngle = 0.0;
+    qreal mMaxAngle = 0.0;
+    qreal mMaxDistance = 0.0;
+};
+
+}
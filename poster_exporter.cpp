@@ -0,0 +1,164 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "poster_exporter.h"
+#include "png_writer.h"
+#include "software_rasterizer.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <cmath>
+
+namespace SpiralFun {
+
+qreal PosterExporter::Stats::getMegaPixelsPerSecond() const
+{
+    return mMilliseconds > 0 ? mPixels / (mMilliseconds * 1000.0) : 0.0;
+}
+
+PosterExporter::PosterExporter(const QRectF& sceneRect, const QSize& size, const QColor& background) :
+    mSceneRect(sceneRect),
+    mSize(size),
+    mBackground(background)
+{
+    Q_ASSERT(!sceneRect.isEmpty());
+    Q_ASSERT(!size.isEmpty());
+
+    // Fit the scene rect in the poster and center it.
+    mScale = std::min(size.width() / sceneRect.width(), size.height() / sceneRect.height());
+    mOrigin = sceneRect.center() - QPointF(size.width(), size.height()) / (2.0 * mScale);
+    mTileHeight = std::clamp(TILE_PIXELS / size.width(), 1, size.height());
+    mTileCount = (size.height() + mTileHeight - 1) / mTileHeight;
+}
+
+void PosterExporter::addLine(const QColor& color, qreal width)
+{
+    mLines.push_back({ color, width, mPoints.size() });
+}
+
+void PosterExporter::addPoint(const QPointF& p)
+{
+    Q_ASSERT(!mLines.empty());
+    mPoints.push_back(p);
+}
+
+void PosterExporter::save(const QString& fileName)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto bins = binSegments();
+    PngWriter png;
+    png.open(fileName, mSize);
+
+    QImage image(mSize.width(), mTileHeight, QImage::Format_RGB32);
+    SoftwareRasterizer rasterizer(image);
+
+    for (int tile = 0; tile < mTileCount; ++tile)
+    {
+        renderTile(tile, bins[tile], rasterizer);
+        writeTile(tile, image, png);
+
+        // Release the bin, such that memory goes down while writing.
+        std::vector<SegmentIndex>().swap(bins[tile]);
+    }
+
+    png.close();
+
+    mStats.mPixels = qint64(mSize.width()) * mSize.height();
+    mStats.mMilliseconds = timer.elapsed();
+    mStats.mTileCount = mTileCount;
+    qDebug() << "Poster saved:" << fileName << "size:" << mSize << "tiles:" << mTileCount
+             << "time:" << mStats.mMilliseconds << "ms" << "MP/s:" << mStats.getMegaPixelsPerSecond();
+}
+
+std::vector<std::vector<PosterExporter::SegmentIndex>> PosterExporter::binSegments() const
+{
+    std::vector<std::vector<SegmentIndex>> bins(mTileCount);
+
+    for (std::size_t l = 0; l < mLines.size(); ++l)
+    {
+        const Line& line = mLines[l];
+        const std::size_t end = l + 1 < mLines.size() ? mLines[l + 1].mFirstPoint : mPoints.size();
+
+        // Pixels within half the width plus anti-aliasing from a segment can be drawn.
+        const qreal reach = line.mWidth * mScale / 2.0 + 1.0;
+
+        for (std::size_t i = line.mFirstPoint; i + 1 < end; ++i)
+        {
+            const QPointF a = (mPoints[i] - mOrigin) * mScale;
+            const QPointF b = (mPoints[i + 1] - mOrigin) * mScale;
+
+            if (std::max(a.x(), b.x()) + reach < 0.0 || std::min(a.x(), b.x()) - reach > mSize.width())
+                continue;
+
+            const qreal top = std::min(a.y(), b.y()) - reach;
+            const qreal bottom = std::max(a.y(), b.y()) + reach;
+
+            if (bottom < 0.0 || top > mSize.height())
+                continue;
+
+            const int firstTile = std::max(0, int(top) / mTileHeight);
+            const int lastTile = std::min(mTileCount - 1, int(bottom) / mTileHeight);
+
+            for (int tile = firstTile; tile <= lastTile; ++tile)
+                bins[tile].push_back(SegmentIndex(i));
+        }
+    }
+
+    return bins;
+}
+
+// The segments are in line order, each line is drawn as a polyline.
+void PosterExporter::renderTile(int tile, const std::vector<SegmentIndex>& segments, SoftwareRasterizer& rasterizer) const
+{
+    rasterizer.setTransform(mScale, mOrigin * mScale + QPointF(0, tile * mTileHeight));
+    rasterizer.clear(mBackground);
+    std::size_t l = 0;
+    bool drawing = false;
+
+    for (const SegmentIndex i : segments)
+    {
+        while (l + 1 < mLines.size() && mLines[l + 1].mFirstPoint <= i)
+        {
+            if (drawing)
+            {
+                rasterizer.endPolyline();
+                drawing = false;
+            }
+
+            ++l;
+        }
+
+        if (!drawing)
+        {
+            rasterizer.beginPolyline(mLines[l].mColor, mLines[l].mWidth);
+            drawing = true;
+        }
+
+        rasterizer.drawSegment(mPoints[i], mPoints[i + 1]);
+    }
+
+    if (drawing)
+        rasterizer.endPolyline();
+}
+
+void PosterExporter::writeTile(int tile, const QImage& image, PngWriter& png) const
+{
+    const int rows = std::min(mTileHeight, mSize.height() - tile * mTileHeight);
+    std::vector<uchar> rgb(std::size_t(mSize.width()) * 3);
+
+    for (int y = 0; y < rows; ++y)
+    {
+        const auto* pixels = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+
+        for (int x = 0; x < mSize.width(); ++x)
+        {
+            rgb[x * 3] = qRed(pixels[x]);
+            rgb[x * 3 + 1] = qGreen(pixels[x]);
+            rgb[x * 3 + 2] = qBlue(pixels[x]);
+        }
+
+        png.writeRow(rgb.data());
+    }
+}
+
+}
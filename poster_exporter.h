@@ -0,0 +1,81 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QColor>
+#include <QImage>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+namespace SpiralFun {
+
+class PngWriter;
+class SoftwareRasterizer;
+
+// Renders lines into a PNG file of any size with the SoftwareRasterizer.
+//
+// The poster is rendered in tiles of about TILE_PIXELS pixels. As a PNG file
+// is written row by row, a tile spans the full width of the poster. The line
+// segments are binned per tile by their bounding box, and each tile is written
+// to the PNG file before the next is rendered. The memory needed for pixels is
+// a single tile, whatever the size of the poster.
+class PosterExporter
+{
+public:
+    static constexpr int TILE_PIXELS = 1024 * 1024;
+
+    struct Stats
+    {
+        qint64 mPixels = 0;
+        qint64 mMilliseconds = 0;
+        unsigned mTileCount = 0;
+
+        qreal getMegaPixelsPerSecond() const;
+    };
+
+    // The poster shows sceneRect of the scene scaled to size. Line widths are
+    // scaled as well.
+    PosterExporter(const QRectF& sceneRect, const QSize& size, const QColor& background);
+
+    void addLine(const QColor& color, qreal width);
+
+    // Add a point to the last added line.
+    void addPoint(const QPointF& p);
+
+    // Throws RuntimeException on failure.
+    void save(const QString& fileName);
+
+    const QSize& getSize() const { return mSize; }
+    int getTileHeight() const { return mTileHeight; }
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Line
+    {
+        QColor mColor;
+        qreal mWidth;
+        std::size_t mFirstPoint;
+    };
+
+    // Segment from mPoints[index] to mPoints[index + 1]
+    using SegmentIndex = uint32_t;
+
+    std::vector<std::vector<SegmentIndex>> binSegments() const;
+    void renderTile(int tile, const std::vector<SegmentIndex>& segments, SoftwareRasterizer& rasterizer) const;
+    void writeTile(int tile, const QImage& image, PngWriter& png) const;
+
+    QRectF mSceneRect;
+    QSize mSize;
+    QColor mBackground;
+    qreal mScale;
+    QPointF mOrigin; // scene position of the top left pixel
+    int mTileHeight;
+    int mTileCount;
+    std::vector<Line> mLines;
+    std::vector<QPointF> mPoints;
+    Stats mStats;
+};
+
+}
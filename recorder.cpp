@@ -7,6 +7,7 @@
 #include "video_encoder.h"
 #include <QFile>
 #include <QThread>
+#include <utility>
 
 namespace SpiralFun {
 
@@ -39,12 +40,6 @@ Recorder::Recorder(std::unique_ptr<SceneGrabber> sceneGrabber) :
 
 Recorder::~Recorder()
 {
-    if (mRecordingThread)
-    {
-        qDebug() << "Wait for recording thread to finish";
-        mRecordingThread->wait();
-    }
-
     if (mRecording)
     {
         qDebug() << "Stop recording and remove file:" << mFileName;
@@ -87,6 +82,14 @@ bool Recorder::startRecording(FrameRate frameRate, const QString& baseNameSuffix
 
     mRecording = true;
     mFrameNumber = 0;
+    mStats = {};
+    mEncodeFailed = false;
+    mEncodedFrameCount = 0;
+    mStopEncoding = false;
+    mEncoderThread.reset(QThread::create([this]{ encodeFrames(); }));
+    mEncoderThread->start();
+    mStartFrameAllocations = mSceneGrabber ? mSceneGrabber->getFrameAllocationCount() : 0;
+    mRecordingTimer.start();
     return true;
 }
 
@@ -95,9 +98,21 @@ void Recorder::stopRecording(bool scanMediaFile)
     if (!mRecording)
         return;
 
+    stopEncoderThread();
     mEncoder->close();
     mRecording = false;
 
+    mStats.mFrameCount = mEncodedFrameCount;
+    const qint64 recordingTime = mRecordingTimer.elapsed();
+    mStats.mFramesPerSecond = recordingTime > 0 ? mStats.mFrameCount * 1000.0 / recordingTime : 0.0;
+
+    if (mSceneGrabber)
+        mStats.mFrameAllocations = mSceneGrabber->getFrameAllocationCount() - mStartFrameAllocations;
+
+    qDebug() << "Recording stopped, frames:" << mStats.mFrameCount << "fps:" << mStats.mFramesPerSecond
+             << "max queue:" << mStats.mMaxQueueDepth << "stall:" << mStats.mStallTime.count() << "ms"
+             << "frame allocations:" << mStats.mFrameAllocations;
+
     if (scanMediaFile)
         Utils::scanMediaFile(mFileName);
 }
@@ -115,11 +130,8 @@ bool Recorder::addFrame(const QRectF& recordingRect, const FrameAddedCallback& f
     calcFramePosition(frameRect);
 
     const bool grabbed = mSceneGrabber->grabScene(frameRect,
-        [this, frameAddedCallback](QImage&& img){
-            mFrame = std::make_unique<QImage>(std::forward<QImage>(img));
-            runRecordFrameThread([frameAddedCallback](bool added){
-                if (frameAddedCallback) frameAddedCallback(added);
-            });
+        [this, position=mFramePosition, frameAddedCallback](QImage&& img){
+            queueFrame({ std::forward<QImage>(img), position }, frameAddedCallback);
         });
 
     if (!grabbed)
@@ -157,22 +169,100 @@ void Recorder::calcFramePosition(const QRectF& frameRect)
     mFramePosition = frameRect.translated(-mFullFrameRect.topLeft()).toRect().topLeft();
 }
 
-void Recorder::recordFrame()
+void Recorder::queueFrame(Frame&& frame, const FrameAddedCallback& frameAddedCallback)
+{
+    Q_ASSERT(!mWaitingFrame);
+    bool queued = false;
+
+    {
+        std::lock_guard lock(mQueueMutex);
+
+        if (mFrameQueue.size() < MAX_QUEUED_FRAMES)
+        {
+            mFrameQueue.push_back(std::move(frame));
+            mStats.mMaxQueueDepth = std::max(mStats.mMaxQueueDepth, mFrameQueue.size());
+            queued = true;
+        }
+    }
+
+    if (!queued)
+    {
+        mWaitingFrame = std::move(frame);
+        mWaitingCallback = frameAddedCallback;
+        mStallTimer.start();
+        return;
+    }
+
+    mQueueCondition.notify_one();
+
+    if (frameAddedCallback)
+        frameAddedCallback(!mEncodeFailed);
+}
+
+// Called on the GUI thread after the worker took a frame from the queue.
+void Recorder::handleFrameDequeued()
+{
+    if (!mWaitingFrame)
+        return;
+
+    Frame frame = std::move(*mWaitingFrame);
+    mWaitingFrame.reset();
+    mStats.mStallTime += std::chrono::milliseconds(mStallTimer.elapsed());
+    queueFrame(std::move(frame), std::exchange(mWaitingCallback, nullptr));
+}
+
+void Recorder::encodeFrames()
 {
     Q_ASSERT(mEncoder);
-    Q_ASSERT(mFrame);
-    mLastFrameAdded = mEncoder->push(*mFrame, mFramePosition.x(), mFramePosition.y());
+
+    while (true)
+    {
+        Frame frame;
+
+        {
+            std::unique_lock lock(mQueueMutex);
+            mQueueCondition.wait(lock, [this]{ return !mFrameQueue.empty() || mStopEncoding; });
+
+            // Stop when all frames are encoded.
+            if (mFrameQueue.empty())
+                return;
+
+            frame = std::move(mFrameQueue.front());
+            mFrameQueue.pop_front();
+        }
+
+        QMetaObject::invokeMethod(this, [this]{ handleFrameDequeued(); }, Qt::QueuedConnection);
+
+        if (mEncodeFailed)
+            continue;
+
+        if (mEncoder->push(frame.mImage, frame.mPosition.x(), frame.mPosition.y()))
+        {
+            ++mEncodedFrameCount;
+        }
+        else
+        {
+            qWarning() << "Failed to encode frame";
+            mEncodeFailed = true;
+        }
+    }
 }
 
-void Recorder::runRecordFrameThread(const FrameAddedCallback& whenFinished)
+void Recorder::stopEncoderThread()
 {
-    mLastFrameAdded = false;
-    QThread* thread = QThread::create([this]{ recordFrame(); });
-    mRecordingThread.reset(thread);
-    QObject::connect(thread, &QThread::finished, this,
-        [this, whenFinished]{ whenFinished(mLastFrameAdded); },
-        Qt::SingleShotConnection);
-    mRecordingThread->start();
+    if (!mEncoderThread)
+        return;
+
+    {
+        std::lock_guard lock(mQueueMutex);
+        mStopEncoding = true;
+    }
+
+    mQueueCondition.notify_one();
+    mEncoderThread->wait();
+    mEncoderThread = nullptr;
+    mWaitingFrame.reset();
+    mWaitingCallback = nullptr;
 }
 
 }
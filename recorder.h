@@ -4,11 +4,22 @@
 
 #include "scene_grabber.h"
 #include "video_encoder_interface.h"
+#include <QElapsedTimer>
 #include <QString>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 namespace SpiralFun {
 
+// Grabbed frames are queued for a worker thread that encodes them while play
+// continues. When the queue is full, the frame added callback is delayed till
+// there is room.
 class Recorder : public QObject
 {
     Q_OBJECT
@@ -21,6 +32,24 @@ public:
     enum Format { FMT_GIF, FMT_VIDEO };
     Q_ENUM(Format);
 
+    static constexpr std::size_t MAX_QUEUED_FRAMES = 4;
+
+    struct Stats
+    {
+        int mFrameCount = 0;
+        std::size_t mMaxQueueDepth = 0;
+
+        // Time that frames waited for room in the queue.
+        std::chrono::milliseconds mStallTime{0};
+
+        // Encoded frames per second of recording time.
+        qreal mFramesPerSecond = 0.0;
+
+        // Image buffers allocated for grabbed frames. Buffers are reused, so
+        // this stays at the number of frames in flight.
+        int mFrameAllocations = 0;
+    };
+
     static std::unique_ptr<Recorder> createRecorder(Format format, std::unique_ptr<SceneGrabber> sceneGrabber);
 
     explicit Recorder(std::unique_ptr<SceneGrabber> sceneGrabber = nullptr);
@@ -30,34 +59,61 @@ public:
     void setBitsPerFrame(int bitsPerFrame) { mBitsPerFrame = bitsPerFrame; }
     const QRect& getFullFrameRect() const { return mFullFrameRect; }
     const QString& getFileName() const { return mFileName; }
+    const Stats& getStats() const { return mStats; }
 
     bool startRecording(FrameRate frameRate, const QString& baseNameSuffix = "");
+
+    // Waits till all queued frames are encoded.
     void stopRecording(bool scanMediaFile);
 
+    // The callback is called when the frame is queued. frameAdded is false if
+    // encoding of a previous frame failed.
     using FrameAddedCallback = std::function<void(bool frameAdded)>;
     bool addFrame(const FrameAddedCallback& frameAddedCallback);
     bool addFrame(const QRectF& recordingRect, const FrameAddedCallback& frameAddedCallback);
     static int frameRateToFps(FrameRate frameRate);
 
     QRectF sceneRectToRecordingRect(const QRectF& sceneRect) const { return mSceneGrabber->getGrabRect(sceneRect); }
-    QRectF calcBoundingRectangle(const CircleList& circles) const { return mSceneGrabber->calcBoundingRectangle(circles); }
+    QRectF calcBoundingRectangle(const SpiralEngine& engine) const { return mSceneGrabber->calcBoundingRectangle(engine); }
 
 private:
+    struct Frame
+    {
+        QImage mImage;
+        QPoint mPosition;
+    };
+
     void calcFramePosition(const QRectF& frameRect);
-    void recordFrame();
-    void runRecordFrameThread(const FrameAddedCallback& whenFinished);
+    void queueFrame(Frame&& frame, const FrameAddedCallback& frameAddedCallback);
+    void handleFrameDequeued();
+    void encodeFrames();
+    void stopEncoderThread();
 
     std::unique_ptr<SceneGrabber> mSceneGrabber;
     std::unique_ptr<IVideoEncoder> mEncoder;
     QString mFileName;
     int mBitsPerFrame = 80000;
     bool mRecording = false;
-    std::unique_ptr<QImage> mFrame;
-    bool mLastFrameAdded = false;
     int mFrameNumber = 0;
     QRect mFullFrameRect;
     QPoint mFramePosition;
-    std::unique_ptr<QThread> mRecordingThread;
+
+    std::unique_ptr<QThread> mEncoderThread;
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueCondition;
+    std::deque<Frame> mFrameQueue; // guarded by mQueueMutex
+    bool mStopEncoding = false; // guarded by mQueueMutex
+    std::atomic_bool mEncodeFailed = false;
+    std::atomic_int mEncodedFrameCount = 0;
+
+    // Frame that waits for room in the queue.
+    std::optional<Frame> mWaitingFrame;
+    FrameAddedCallback mWaitingCallback;
+    QElapsedTimer mStallTimer;
+
+    QElapsedTimer mRecordingTimer;
+    int mStartFrameAllocations = 0;
+    Stats mStats;
 };
 
 }
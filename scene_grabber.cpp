@@ -1,8 +1,11 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #include "scene_grabber.h"
+#include "circle.h"
+#include "software_rasterizer.h"
 #include <QQuickItemGrabResult>
 #include <QQuickWindow>
+#include <cstring>
 
 namespace SpiralFun {
 
@@ -20,6 +23,14 @@ SceneGrabber::SceneGrabber(QQuickItem* scene, const QRectF& sceneRect) :
     mPixelRatio = win->effectiveDevicePixelRatio();
 }
 
+SceneGrabber::~SceneGrabber() = default;
+
+void SceneGrabber::setRenderers(const Renderer& lineRenderer, const Renderer& overlayRenderer)
+{
+    mLineRenderer = lineRenderer;
+    mOverlayRenderer = overlayRenderer;
+}
+
 QSize SceneGrabber::getImageGrabSize() const
 {
     // In Qt6.6.3 I had to multiply by pixel ratio. grabImage() seems to do that now.
@@ -39,6 +50,9 @@ bool SceneGrabber::grabScene(const QRect& cutRect, const Callback& callback)
     Q_ASSERT(callback);
     qDebug() << "Cut rect:" << cutRect;
 
+    if (mLineRenderer)
+        return renderScene(cutRect, callback);
+
     // Make sure all rendering is done before grabbing
     mScene->update();
 
@@ -47,6 +61,8 @@ bool SceneGrabber::grabScene(const QRect& cutRect, const Callback& callback)
     if (!grabResult)
         return false;
 
+    ++mWindowGrabCount;
+
     QObject::connect(grabResult.get(), &QQuickItemGrabResult::ready, this,
         [this, grabResult, cutRect, callback]{
             QImage img = extractRect(grabResult->image(), cutRect);
@@ -56,19 +72,17 @@ bool SceneGrabber::grabScene(const QRect& cutRect, const Callback& callback)
     return true;
 }
 
-QRectF SceneGrabber::calcBoundingRectangle(const CircleList& circles) const
+QRectF SceneGrabber::calcBoundingRectangle(const SpiralEngine& engine) const
 {
-    QRectF rect = circles[1]->boundingRect();
-    rect = QRectF(QPointF(0, 0), rect.size() * mPixelRatio);
-    rect.translate(circles[1]->x() * mPixelRatio, circles[1]->y() * mPixelRatio);
+    QRectF rect;
 
-    for (unsigned i = 2; i < circles.size(); ++i)
+    for (unsigned i = 1; i < engine.size(); ++i)
     {
-        const auto& c = circles[i];
-        auto r = c->boundingRect();
-        r = QRectF(QPointF(0, 0), r.size() * mPixelRatio);
-        r.translate(c->x() * mPixelRatio, c->y() * mPixelRatio);
-        rect |= r;
+        // Leave room for the outline of a selected circle.
+        const qreal r = engine.getRadius(i) + Circle::SELECT_PEN_WIDTH / 2.0;
+        const QPointF& center = engine.getCenter(i);
+        const QRectF circleRect(center.x() - r, center.y() - r, r * 2, r * 2);
+        rect |= getGrabRect(circleRect);
     }
 
     return rect;
@@ -96,9 +110,81 @@ QRect SceneGrabber::getSpiralCutRect() const
     return intCutRect;
 }
 
+int SceneGrabber::getFrameAllocationCount() const
+{
+    const int poolAllocations = mFramePool ? mFramePool->getAllocationCount() : 0;
+    return poolAllocations + mWindowGrabCount;
+}
+
+// The image has the RGBA byte order of a window grab. As with a window grab, the
+// callback is called from the event loop.
+bool SceneGrabber::renderScene(const QRect& cutRect, const Callback& callback)
+{
+    if (!mFramePool)
+    {
+        // Buffers for partial frames can be reused for full frames.
+        const QSize fullSize = getSpiralCutRect().size().expandedTo(cutRect.size());
+        mFramePool = std::make_shared<FramePool>(qsizetype(fullSize.width()) * fullSize.height() * 4);
+    }
+
+    updateLineLayer();
+
+    QImage frame = mFramePool->acquire(cutRect.size(), QImage::Format_RGBA8888_Premultiplied);
+    SoftwareRasterizer rasterizer(frame);
+    rasterizer.setTransform(mPixelRatio, cutRect.topLeft());
+
+    // Same background as the scene in main.qml
+    const QRect layerRect = cutRect & mLineLayerRect;
+    if (layerRect != cutRect)
+        rasterizer.clear(Qt::black);
+
+    const qsizetype rowBytes = qsizetype(layerRect.width()) * 4;
+
+    for (int y = layerRect.top(); y <= layerRect.bottom(); ++y)
+    {
+        const uchar* src = mLineLayer.constScanLine(y - mLineLayerRect.y()) + (layerRect.x() - mLineLayerRect.x()) * 4;
+        uchar* dst = frame.scanLine(y - cutRect.y()) + (layerRect.x() - cutRect.x()) * 4;
+        std::memcpy(dst, src, rowBytes);
+    }
+
+    if (mOverlayRenderer)
+        mOverlayRenderer(rasterizer);
+
+    QMetaObject::invokeMethod(this, [callback, img=std::move(frame)]() mutable { callback(std::move(img)); },
+                              Qt::QueuedConnection);
+    return true;
+}
+
+// The layer and its rasterizer persist, such that the mask of the rasterizer is
+// not allocated again for each frame.
+void SceneGrabber::updateLineLayer()
+{
+    if (!mLineRasterizer)
+    {
+        mLineLayerRect = getSpiralCutRect();
+        mLineLayer = QImage(mLineLayerRect.size(), QImage::Format_RGBA8888_Premultiplied);
+        mLineRasterizer = std::make_unique<SoftwareRasterizer>(mLineLayer);
+        mLineRasterizer->setTransform(mPixelRatio, mLineLayerRect.topLeft());
+        mLineRasterizer->clear(Qt::black);
+    }
+
+    mLineRenderer(*mLineRasterizer);
+}
+
+// The cut rect is returned as a view on the grabbed image, which stays alive as
+// long as the view exists. The rows of the view have the stride of the grabbed
+// image.
 QImage SceneGrabber::extractRect(const QImage& grabbedImg, const QRect& cutRect)
 {
-    return grabbedImg.copy(cutRect);
+    // Parts outside the grabbed image must be filled in.
+    if (!grabbedImg.rect().contains(cutRect) || grabbedImg.depth() != 32)
+        return grabbedImg.copy(cutRect);
+
+    auto* source = new QImage(grabbedImg);
+    const uchar* bits = source->constBits() + cutRect.y() * source->bytesPerLine() + cutRect.x() * 4;
+
+    return QImage(bits, cutRect.width(), cutRect.height(), source->bytesPerLine(), source->format(),
+                  [](void* info){ delete static_cast<QImage*>(info); }, source);
 }
 
 }
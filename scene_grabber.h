@@ -1,11 +1,14 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #pragma once
-#include "circle.h"
+#include "frame_pool.h"
+#include "spiral_engine.h"
 #include <QQuickItem>
 
 namespace SpiralFun {
 
+class SoftwareRasterizer;
+
 class SceneGrabber : public QObject
 {
     Q_OBJECT
@@ -13,7 +16,25 @@ class SceneGrabber : public QObject
 public:
     using Callback = std::function<void(QImage&&)>;
 
+    // Draws the scene in scene coordinates.
+    using Renderer = std::function<void(SoftwareRasterizer& rasterizer)>;
+
     SceneGrabber(QQuickItem* scene, const QRectF& sceneRect);
+    ~SceneGrabber();
+
+    // With renderers only the cut rect is drawn on the CPU at the time of the
+    // grab, instead of rendering and reading back the whole window on the GPU.
+    // This does not depend on the window being updated. The images are drawn in
+    // pooled buffers that are reused once the previous images are released.
+    //
+    // The line renderer draws on a layer of the full spiral cut rect that keeps
+    // its pixels between grabs, such that it only needs to draw what was added
+    // since its previous call. The overlay renderer draws the moving parts, e.g.
+    // the circles, on each frame after the layer is copied to it.
+    void setRenderers(const Renderer& lineRenderer, const Renderer& overlayRenderer);
+
+    // Number of image buffers allocated for grabs.
+    int getFrameAllocationCount() const;
 
     QRect getSpiralCutRect() const;
     bool grabScene(const Callback& callback);
@@ -22,17 +43,28 @@ public:
     // Calculate the bounding rectangle for circles 1..N-1
     // Those are the circles that move.
     // The rectangle position and size are relative to the full scene rect.
-    QRectF calcBoundingRectangle(const CircleList& circles) const;
+    QRectF calcBoundingRectangle(const SpiralEngine& engine) const;
 
     QRectF getGrabRect(const QRectF& sceneRect) const;
 
 private:
     QSize getImageGrabSize() const;
     QImage extractRect(const QImage& grabbedImg, const QRect& cutRect);
+    bool renderScene(const QRect& cutRect, const Callback& callback);
+    void updateLineLayer();
 
     QQuickItem* mScene;
     QRectF mSceneRect;
     qreal mPixelRatio = 1.0;
+    Renderer mLineRenderer;
+    Renderer mOverlayRenderer;
+    std::shared_ptr<FramePool> mFramePool;
+    QRect mLineLayerRect;
+    QImage mLineLayer;
+    std::unique_ptr<SoftwareRasterizer> mLineRasterizer;
+
+    // A window grab always gets a new image.
+    int mWindowGrabCount = 0;
 };
 
 }
@@ -1,10 +1,13 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #pragma once
+#include "line_history.h"
+#include "line_tessellator.h"
 #include <QColor>
 #include <QPointF>
 #include <QSGFlatColorMaterial>
 #include <QSGNode>
+#include <QSGVertexColorMaterial>
 #include <functional>
 #include <vector>
 
@@ -19,14 +22,37 @@ private:
     QSGMaterialType mType;
 };
 
+// Material for the batched lines of one line width, see Line::setNodeMaterial
+// for the reason of a unique type.
+class LineVertexColorMaterial : public QSGVertexColorMaterial
+{
+public:
+    QSGMaterialType* type() const override { return &const_cast<QSGMaterialType&>(mType); }
+
+private:
+    QSGMaterialType mType;
+};
+
 struct Line
 {
+      // Points not yet added to the scene graph.
       std::vector<QPointF> mLinePoints;
+
+      // All points of the line.
+      LineHistory mHistory;
+
       QColor mColor;
       int mLineWidth = 1;
       LineMaterial* mMaterial = nullptr;
       QSGNode* mRoot = nullptr;
 
+      // Node to which new points are added.
+      QSGGeometryNode* mNode = nullptr;
+      unsigned mNodeVertexCount = 0;
+
+      // Tessellation state for the triangles renderer.
+      LineTessellator mTessellator;
+
       void addPoint(const QPointF& p) { mLinePoints.push_back(p); }
       void setNodeMaterial(QSGGeometryNode* node);
 };
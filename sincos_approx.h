@@ -0,0 +1,65 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <cmath>
+
+namespace SpiralFun::SincosApprox {
+
+// Sine and cosine approximations shared by the scalar and SIMD curve kernels,
+// such that all kernels produce the same curves.
+//
+// The argument x is reduced to r in [-pi/4, pi/4] with x = q * pi/2 + r. Pi/2
+// is split in a 33-bit high part and a low part, such that q * PIO2_HI is exact
+// for |q| < 2^20, i.e. |x| < 1.6e6. On [-pi/4, pi/4] the Cephes polynomials have
+// an error < 2.5e-16.
+
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double PIO2_HI = 1.57079632673412561417e+00;
+constexpr double PIO2_LO = 6.07710050650619224932e-11;
+
+constexpr double SIN_COEF[] = {
+    1.58962301576546568060e-10,
+    -2.50507477628578072866e-8,
+    2.75573136213857245213e-6,
+    -1.98412698295895385996e-4,
+    8.33333333332211858878e-3,
+    -1.66666666666666307295e-1
+};
+
+constexpr double COS_COEF[] = {
+    -1.13585365213876817300e-11,
+    2.08757008419747316778e-9,
+    -2.75573141792967388112e-7,
+    2.48015872888517045348e-5,
+    -1.38888888888730564116e-3,
+    4.16666666666665929218e-2
+};
+
+inline void sincos(double x, double& s, double& c)
+{
+    const double q = std::nearbyint(x * TWO_OVER_PI);
+    const double r = (x - q * PIO2_HI) - q * PIO2_LO;
+    const double z = r * r;
+
+    double ps = SIN_COEF[0];
+    double pc = COS_COEF[0];
+
+    for (int i = 1; i < 6; ++i)
+    {
+        ps = ps * z + SIN_COEF[i];
+        pc = pc * z + COS_COEF[i];
+    }
+
+    const double sr = r + r * z * ps;
+    const double cr = 1.0 - 0.5 * z + z * z * pc;
+    const int quadrant = static_cast<long long>(q) & 3;
+    s = (quadrant & 1) ? cr : sr;
+    c = (quadrant & 1) ? sr : cr;
+
+    if (quadrant >= 2)
+        s = -s;
+    if (quadrant == 1 || quadrant == 2)
+        c = -c;
+}
+
+}
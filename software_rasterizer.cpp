@@ -0,0 +1,305 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "software_rasterizer.h"
+#include "exception.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace SpiralFun {
+
+namespace {
+
+// Multiply 8 bit values with rounding: a * b / 255
+inline int mul255(int a, int b)
+{
+    const int t = a * b + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// Limit [left, right] to the x values where lo <= k * x + m <= hi
+void clipLinear(qreal k, qreal m, qreal lo, qreal hi, qreal& left, qreal& right)
+{
+    if (std::abs(k) < 1e-12)
+    {
+        if (m < lo || m > hi)
+            right = left - 1.0;
+
+        return;
+    }
+
+    const qreal x1 = (lo - m) / k;
+    const qreal x2 = (hi - m) / k;
+    left = std::max(left, std::min(x1, x2));
+    right = std::min(right, std::max(x1, x2));
+}
+
+// Get the span of row y within distance r of segment ab. As the area around
+// the segment is convex, the span is the union of the spans of the disks
+// around a and b, and of the rectangle between them.
+bool getCapsuleSpan(const QPointF& a, const QPointF& b, qreal r, qreal y, qreal& left, qreal& right)
+{
+    left = std::numeric_limits<qreal>::max();
+    right = std::numeric_limits<qreal>::lowest();
+
+    for (const QPointF& c : { a, b })
+    {
+        const qreal dy = y - c.y();
+
+        if (std::abs(dy) <= r)
+        {
+            const qreal h = std::sqrt(r * r - dy * dy);
+            left = std::min(left, c.x() - h);
+            right = std::max(right, c.x() + h);
+        }
+    }
+
+    const QPointF ab = b - a;
+    const qreal length2 = QPointF::dotProduct(ab, ab);
+
+    if (length2 > 0.0)
+    {
+        qreal rectLeft = std::numeric_limits<qreal>::lowest();
+        qreal rectRight = std::numeric_limits<qreal>::max();
+        const qreal dy = y - a.y();
+        const qreal bandWidth = r * std::sqrt(length2);
+
+        // Distance to the line through a and b, and position along the segment.
+        clipLinear(ab.y(), -a.x() * ab.y() - dy * ab.x(), -bandWidth, bandWidth, rectLeft, rectRight);
+        clipLinear(ab.x(), -a.x() * ab.x() + dy * ab.y(), 0.0, length2, rectLeft, rectRight);
+
+        if (rectLeft <= rectRight)
+        {
+            left = std::min(left, rectLeft);
+            right = std::max(right, rectRight);
+        }
+    }
+
+    return left <= right;
+}
+
+SoftwareRasterizer::PixelFormat getPixelFormat(const QImage& image)
+{
+    switch (image.format())
+    {
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGB32:
+        return SoftwareRasterizer::PixelFormat::ARGB32_PREMULTIPLIED;
+    case QImage::Format_RGBA8888_Premultiplied:
+    case QImage::Format_RGBX8888:
+        return SoftwareRasterizer::PixelFormat::RGBA8888_PREMULTIPLIED;
+    default:
+        throw RuntimeException(QString("Unsupported image format for rendering: %1").arg(int(image.format())));
+    }
+}
+
+}
+
+SoftwareRasterizer::SoftwareRasterizer(QImage& image) :
+    SoftwareRasterizer(image.bits(), image.width(), image.height(), image.bytesPerLine(), getPixelFormat(image))
+{
+}
+
+SoftwareRasterizer::SoftwareRasterizer(uchar* bits, int width, int height, qsizetype bytesPerLine, PixelFormat format) :
+    mBits(bits),
+    mWidth(width),
+    mHeight(height),
+    mBytesPerLine(bytesPerLine)
+{
+    switch (format)
+    {
+    case PixelFormat::ARGB32_PREMULTIPLIED:
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        mBlueOffset = 0;
+        mGreenOffset = 1;
+        mRedOffset = 2;
+        mAlphaOffset = 3;
+#else
+        mAlphaOffset = 0;
+        mRedOffset = 1;
+        mGreenOffset = 2;
+        mBlueOffset = 3;
+#endif
+        break;
+    case PixelFormat::RGBA8888_PREMULTIPLIED:
+        mRedOffset = 0;
+        mGreenOffset = 1;
+        mBlueOffset = 2;
+        mAlphaOffset = 3;
+        break;
+    }
+}
+
+void SoftwareRasterizer::setTransform(qreal scale, const QPointF& offset)
+{
+    mScale = scale;
+    mOffset = offset;
+}
+
+void SoftwareRasterizer::clear(const QColor& color)
+{
+    const int alpha = color.alpha();
+    uchar pixel[4];
+    pixel[mRedOffset] = mul255(color.red(), alpha);
+    pixel[mGreenOffset] = mul255(color.green(), alpha);
+    pixel[mBlueOffset] = mul255(color.blue(), alpha);
+    pixel[mAlphaOffset] = alpha;
+
+    for (int y = 0; y < mHeight; ++y)
+    {
+        uchar* line = mBits + y * mBytesPerLine;
+
+        for (int x = 0; x < mWidth; ++x)
+            std::copy(pixel, pixel + 4, line + x * 4);
+    }
+}
+
+void SoftwareRasterizer::beginPolyline(const QColor& color, qreal width)
+{
+    if (mMask.empty())
+        mMask.resize(std::size_t(mWidth) * mHeight);
+
+    mColor = color;
+    mHalfWidth = width * mScale / 2.0;
+    mMaskRect = {};
+    mHasPoint = false;
+}
+
+void SoftwareRasterizer::lineTo(const QPointF& p)
+{
+    const QPointF pixel = toPixel(p);
+
+    if (mHasPoint)
+        addSegment(mLastPixel, pixel);
+
+    mLastPixel = pixel;
+    mHasPoint = true;
+}
+
+void SoftwareRasterizer::endPolyline()
+{
+    blendMask();
+    mHasPoint = false;
+}
+
+void SoftwareRasterizer::drawSegment(const QPointF& a, const QPointF& b)
+{
+    addSegment(toPixel(a), toPixel(b));
+}
+
+void SoftwareRasterizer::drawPolyline(const QPointF* begin, const QPointF* end, const QColor& color, qreal width)
+{
+    beginPolyline(color, width);
+
+    for (const QPointF* p = begin; p != end; ++p)
+        lineTo(*p);
+
+    endPolyline();
+}
+
+// The coverage of a pixel is estimated from the distance of its center to the
+// segment: fully covered within halfWidth - 0.5, not covered beyond halfWidth + 0.5.
+// Per row only the pixels between these two distances need the distance.
+void SoftwareRasterizer::addSegment(const QPointF& a, const QPointF& b)
+{
+    const qreal reach = mHalfWidth + 0.5;
+    const qreal inner = mHalfWidth - 0.5;
+    const int left = std::max(0, int(std::floor(std::min(a.x(), b.x()) - reach)));
+    const int right = std::min(mWidth - 1, int(std::ceil(std::max(a.x(), b.x()) + reach)));
+    const int top = std::max(0, int(std::floor(std::min(a.y(), b.y()) - reach)));
+    const int bottom = std::min(mHeight - 1, int(std::ceil(std::max(a.y(), b.y()) + reach)));
+
+    if (left > right || top > bottom)
+        return;
+
+    const QPointF ab = b - a;
+    const qreal length2 = QPointF::dotProduct(ab, ab);
+
+    for (int y = top; y <= bottom; ++y)
+    {
+        const qreal py = y + 0.5;
+        qreal outerLeft;
+        qreal outerRight;
+
+        if (!getCapsuleSpan(a, b, reach, py, outerLeft, outerRight))
+            continue;
+
+        // Pixels with their center in the span.
+        const int spanLeft = std::max(left, int(std::ceil(outerLeft - 0.5)));
+        const int spanRight = std::min(right, int(std::floor(outerRight - 0.5)));
+        int fullLeft = spanRight + 1;
+        int fullRight = spanRight;
+        qreal innerLeft;
+        qreal innerRight;
+
+        if (inner > 0.0 && getCapsuleSpan(a, b, inner, py, innerLeft, innerRight))
+        {
+            fullLeft = std::max(spanLeft, int(std::ceil(innerLeft - 0.5)));
+            fullRight = std::min(spanRight, int(std::floor(innerRight - 0.5)));
+        }
+
+        uint8_t* mask = mMask.data() + std::size_t(y) * mWidth;
+
+        for (int x = spanLeft; x <= spanRight; ++x)
+        {
+            if (x == fullLeft && fullLeft <= fullRight)
+            {
+                std::fill(mask + fullLeft, mask + fullRight + 1, uint8_t(255));
+                x = fullRight;
+                continue;
+            }
+
+            const QPointF p(x + 0.5, py);
+            const qreal t = length2 > 0.0 ? std::clamp(QPointF::dotProduct(p - a, ab) / length2, 0.0, 1.0) : 0.0;
+            const QPointF d = p - (a + ab * t);
+            const qreal coverage = reach - std::hypot(d.x(), d.y());
+
+            if (coverage <= 0.0)
+                continue;
+
+            const auto value = uint8_t(coverage >= 1.0 ? 255 : std::lround(coverage * 255));
+            mask[x] = std::max(mask[x], value);
+        }
+    }
+
+    mMaskRect |= QRect(left, top, right - left + 1, bottom - top + 1);
+}
+
+void SoftwareRasterizer::blendMask()
+{
+    if (mMaskRect.isEmpty())
+        return;
+
+    const int alpha = mColor.alpha();
+    const int red = mul255(mColor.red(), alpha);
+    const int green = mul255(mColor.green(), alpha);
+    const int blue = mul255(mColor.blue(), alpha);
+
+    for (int y = mMaskRect.top(); y <= mMaskRect.bottom(); ++y)
+    {
+        uint8_t* mask = mMask.data() + std::size_t(y) * mWidth;
+        uchar* line = mBits + y * mBytesPerLine;
+
+        for (int x = mMaskRect.left(); x <= mMaskRect.right(); ++x)
+        {
+            const int coverage = mask[x];
+
+            if (coverage == 0)
+                continue;
+
+            mask[x] = 0;
+            uchar* pixel = line + x * 4;
+            const int srcAlpha = mul255(alpha, coverage);
+            const int inverse = 255 - srcAlpha;
+            pixel[mRedOffset] = mul255(red, coverage) + mul255(pixel[mRedOffset], inverse);
+            pixel[mGreenOffset] = mul255(green, coverage) + mul255(pixel[mGreenOffset], inverse);
+            pixel[mBlueOffset] = mul255(blue, coverage) + mul255(pixel[mBlueOffset], inverse);
+            pixel[mAlphaOffset] = srcAlpha + mul255(pixel[mAlphaOffset], inverse);
+        }
+    }
+
+    mMaskRect = {};
+}
+
+}
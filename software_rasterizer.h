@@ -0,0 +1,75 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QRect>
+#include <cstdint>
+#include <vector>
+
+namespace SpiralFun {
+
+// Draws anti-aliased polylines on the CPU into a 32 bit pixel buffer, such that
+// curves can be rendered without a GPU or a window.
+//
+// A polyline is drawn as the union of capsules around its segments, i.e. with
+// round joins and caps. The coverage of a pixel is its distance to the edge of
+// the union. Coverage of a polyline is collected in a mask first and blended
+// when the polyline ends, such that overlapping segments do not blend twice.
+class SoftwareRasterizer
+{
+public:
+    // Byte order in memory: ARGB32 is the native 0xAARRGGBB of QImage, RGBA8888
+    // are the bytes R, G, B, A. Both have premultiplied alpha.
+    enum class PixelFormat { ARGB32_PREMULTIPLIED, RGBA8888_PREMULTIPLIED };
+
+    // Draw in the pixels of image. The image must be ARGB32 premultiplied, RGB32,
+    // RGBA8888 premultiplied or RGBX8888, otherwise RuntimeException is thrown.
+    explicit SoftwareRasterizer(QImage& image);
+    SoftwareRasterizer(uchar* bits, int width, int height, qsizetype bytesPerLine, PixelFormat format);
+
+    // Map scene coordinates to pixels: pixel = scene * scale - offset
+    void setTransform(qreal scale, const QPointF& offset);
+
+    void clear(const QColor& color);
+
+    // Draw a polyline point by point. The width is in scene units.
+    void beginPolyline(const QColor& color, qreal width);
+    void lineTo(const QPointF& p);
+    void endPolyline();
+
+    // Add a separate segment to the polyline being drawn.
+    void drawSegment(const QPointF& a, const QPointF& b);
+
+    void drawPolyline(const QPointF* begin, const QPointF* end, const QColor& color, qreal width);
+
+private:
+    void addSegment(const QPointF& a, const QPointF& b);
+    void blendMask();
+    QPointF toPixel(const QPointF& p) const { return p * mScale - mOffset; }
+
+    uchar* mBits;
+    int mWidth;
+    int mHeight;
+    qsizetype mBytesPerLine;
+
+    // Byte offsets of the color channels in a pixel
+    int mRedOffset;
+    int mGreenOffset;
+    int mBlueOffset;
+    int mAlphaOffset;
+
+    qreal mScale = 1.0;
+    QPointF mOffset;
+
+    // Polyline being drawn
+    std::vector<uint8_t> mMask;
+    QRect mMaskRect;
+    QColor mColor;
+    qreal mHalfWidth = 0.5;
+    QPointF mLastPixel;
+    bool mHasPoint = false;
+};
+
+}
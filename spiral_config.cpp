@@ -9,6 +9,7 @@
 #include <QImage>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QRegularExpression>
 #include <QSharedPointer>
 #include <QUrl>
 #include <QUrlQuery>
@@ -64,8 +65,8 @@ const std::initializer_list<CircleConfig> EXAMPLE4_CONFIG = {
     { 0.04, -243, 1, Qt::white }
 };
 
-SpiralConfig::SpiralConfig(const CircleList& circles, qreal defaultRadius) :
-    mCircles(circles),
+SpiralConfig::SpiralConfig(const SpiralEngine& engine, qreal defaultRadius) :
+    mEngine(engine),
     mDefaultRadius(defaultRadius)
 {
 }
@@ -77,14 +78,14 @@ QJsonDocument SpiralConfig::createJsonDoc() const
     root.insert(KEY_APP_VERSION, APP_VERSION);
 
     QJsonArray circles;
-    for (const auto& c : mCircles)
+    for (unsigned i = 0; i < mEngine.size(); ++i)
     {
         QJsonObject circle;
-        qreal relRadius = std::round((c->getRadius() / mDefaultRadius) * 100) / 100.0;
+        qreal relRadius = std::round((mEngine.getRadius(i) / mDefaultRadius) * 100) / 100.0;
         circle.insert(KEY_RADIUS, relRadius);
-        circle.insert(KEY_SPEED, c->getSpeed());
-        circle.insert(KEY_DRAW, c->getDraw());
-        circle.insert(KEY_COLOR, c->getColor().name(QColor::HexRgb));
+        circle.insert(KEY_SPEED, mEngine.getSpeed(i));
+        circle.insert(KEY_DRAW, mEngine.getDraw(i));
+        circle.insert(KEY_COLOR, mEngine.getColor(i).name(QColor::HexRgb));
 
         circles.push_back(circle);
     }
@@ -349,9 +350,9 @@ bool SpiralConfig::isValid(const CircleConfigList& cfgList, QString& error) cons
             error = QString("Circle[%1] speed(%2) > %3").arg(i).arg(cfg.mSpeed).arg(MAX_SPEED);
             return false;
         }
-        if (cfg.mDraw > Circle::MAX_DRAW)
+        if (cfg.mDraw > SpiralEngine::MAX_DRAW)
         {
-            error = QString("Circle[%1] draw(%2) > %3").arg(i).arg(cfg.mDraw).arg(Circle::MAX_DRAW);
+            error = QString("Circle[%1] draw(%2) > %3").arg(i).arg(cfg.mDraw).arg(SpiralEngine::MAX_DRAW);
             return false;
         }
         if (cfg.mDraw < 0)
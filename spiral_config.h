@@ -1,9 +1,11 @@
 // Copyright (C) 2023 Michel de Boer
 // License: GPLv3
 #pragma once
-#include "circle.h"
+#include "spiral_engine.h"
+#include <QImage>
 #include <QJsonDocument>
 #include <QJsonValue>
+#include <QObject>
 #include <vector>
 
 namespace SpiralFun {
@@ -45,7 +47,7 @@ public:
     static constexpr int MAX_REL_RADIUS = 12;
     static constexpr int MAX_SPEED = 9999;
 
-    SpiralConfig(const CircleList& circles, qreal defaultRadius);
+    SpiralConfig(const SpiralEngine& engine, qreal defaultRadius);
 
     void save(const QImage& img) const;
     QObjectList getConfigFiles() const;
@@ -61,7 +63,7 @@ private:
     bool isValid(const CircleConfigList& cfgList, QString& error) const;
     QJsonDocument decodeBase64Config(QString b64Config) const;
 
-    const CircleList& mCircles;
+    const SpiralEngine& mEngine;
     const qreal mDefaultRadius;
 };
 
@@ -0,0 +1,325 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "spiral_engine.h"
+#include <QDebug>
+#include <QLineF>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace SpiralFun {
+
+namespace {
+constexpr qreal MIN_DRAW_LENGTH = 2.0;
+}
+
+void SpiralEngine::resize(unsigned size)
+{
+    mDiameters.resize(size, 1);
+    mSpeeds.resize(size, 0);
+    mDraws.resize(size, 0);
+    mColors.resize(size, Qt::white);
+    mCenters.resize(size);
+    mPens.resize(size);
+}
+
+unsigned SpiralEngine::addCircle(const QPointF& center, int diameter, int speed, int draw, const QColor& color)
+{
+    Q_ASSERT(draw >= 0);
+    Q_ASSERT(draw <= MAX_DRAW);
+    mDiameters.push_back(diameter);
+    mSpeeds.push_back(speed);
+    mDraws.push_back(draw);
+    mColors.push_back(color);
+    mCenters.push_back(center);
+    mPens.push_back({});
+    return size() - 1;
+}
+
+void SpiralEngine::setDraw(unsigned index, int draw)
+{
+    Q_ASSERT(draw >= 0);
+    Q_ASSERT(draw <= MAX_DRAW);
+    mDraws[index] = draw;
+}
+
+bool SpiralEngine::hasDrawingCircle() const
+{
+    return std::any_of(mDraws.begin(), mDraws.end(), [](int draw){ return draw > 0; });
+}
+
+void SpiralEngine::resetCenters(const QPointF& center)
+{
+    if (empty())
+        return;
+
+    QPointF c = center;
+    mCenters[0] = c;
+
+    for (unsigned i = 1; i < size(); ++i)
+    {
+        c.ry() -= getRadius(i - 1) + getRadius(i);
+        mCenters[i] = c;
+    }
+}
+
+QRectF SpiralEngine::getMaxRect() const
+{
+    Q_ASSERT(!empty());
+    qreal halfSize = getRadius(0);
+
+    for (unsigned i = 1; i < size(); ++i)
+        halfSize += mDiameters[i];
+
+    const QPointF& center = mCenters[0];
+    return QRectF(center.x() - halfSize, center.y() - halfSize, halfSize * 2, halfSize * 2);
+}
+
+std::vector<int> SpiralEngine::getArmSpeeds() const
+{
+    int lastDrawing = 0;
+
+    for (unsigned i = 1; i < size(); ++i)
+    {
+        if (mDraws[i])
+            lastDrawing = i;
+    }
+
+    // Circle i rotates with the sum of the speeds of circles 1..i.
+    std::vector<int> armSpeeds;
+    int speed = 0;
+
+    for (int i = 1; i <= lastDrawing; ++i)
+    {
+        speed += mSpeeds[i];
+        armSpeeds.push_back(speed);
+    }
+
+    return armSpeeds;
+}
+
+int SpiralEngine::getSpeedDivisor() const
+{
+    int divisor = 0;
+
+    for (int speed : getArmSpeeds())
+        divisor = std::gcd(divisor, speed);
+
+    return divisor;
+}
+
+qreal SpiralEngine::getPeriod() const
+{
+    // All drawing circles are back at their start positions when each arm
+    // made a whole number of rotations. This happens first at 2pi / gcd(speeds).
+    const int divisor = getSpeedDivisor();
+    return divisor > 0 ? 2 * M_PI / divisor : 2 * M_PI;
+}
+
+unsigned SpiralEngine::getSymmetry() const
+{
+    // After 1/k of the period the angle of arm j changed by 2pi * s[j] / k,
+    // with s the arm speeds divided by their gcd. If all s[j] are equal modulo
+    // k, then all arms rotated by the same angle, i.e. the whole curve rotated
+    // about circle 0.
+    const int divisor = getSpeedDivisor();
+
+    if (divisor == 0)
+        return 1;
+
+    const auto armSpeeds = getArmSpeeds();
+    int symmetry = 0;
+
+    for (int speed : armSpeeds)
+        symmetry = std::gcd(symmetry, (speed - armSpeeds.front()) / divisor);
+
+    return symmetry > 0 ? symmetry : 1;
+}
+
+qreal SpiralEngine::getSectorRotation() const
+{
+    const int divisor = getSpeedDivisor();
+
+    if (divisor == 0)
+        return 0.0;
+
+    return -2 * M_PI * (getArmSpeeds().front() / divisor) / getSymmetry();
+}
+
+void SpiralEngine::setPenPoints(unsigned index, PointList* points)
+{
+    mPens[index].mPoints = points;
+}
+
+void SpiralEngine::preparePlay(qreal stepAngle, StepMode stepMode)
+{
+    for (unsigned i = 0; i < size(); ++i)
+    {
+        Pen& pen = mPens[i];
+        pen.mDrawPos = mCenters[i];
+        pen.mDrawnLength = 0.0;
+        pen.mSampleAngle = 0.0;
+    }
+
+    mEvaluator.init(mCenters, mSpeeds);
+    mSamplers.resize(size());
+    mSampleCount = 0;
+
+    mStepMode = stepMode;
+    qreal maxAcceleration = 0.0;
+
+    for (unsigned i = 1; i < size(); ++i)
+    {
+        if (mDraws[i])
+        {
+            mSamplers[i].init(mEvaluator, i);
+            maxAcceleration = std::max(maxAcceleration, mEvaluator.getMaxAcceleration(i));
+        }
+    }
+
+    if (mStepMode == StepMode::RECURRENCE)
+    {
+        // Fixed sub steps small enough for the maximum acceleration anywhere
+        // on the curves.
+        mSubSteps = std::max(1, int(std::ceil(stepAngle * std::sqrt(maxAcceleration / (8 * MAX_PIXEL_ERROR)))));
+        mStepper.init(mEvaluator, 0.0, stepAngle / mSubSteps);
+    }
+}
+
+void SpiralEngine::advance(qreal fromAngle, qreal toAngle, unsigned steps)
+{
+    Q_ASSERT(steps > 0);
+
+    if (mStepMode == StepMode::RECURRENCE)
+    {
+        Q_ASSERT(qFuzzyCompare(mStepper.getAngle() + 1.0, fromAngle + 1.0));
+        stepCurves(steps);
+        return;
+    }
+
+    const qreal stepAngle = (toAngle - fromAngle) / steps;
+    mEvaluator.evaluate(toAngle, mCenters);
+
+    for (unsigned i = 1; i < size(); ++i)
+    {
+        if (mDraws[i])
+            sampleCurve(i, toAngle, stepAngle);
+    }
+}
+
+void SpiralEngine::sampleCurve(unsigned index, qreal toAngle, qreal stepAngle)
+{
+    Pen& pen = mPens[index];
+    mSamplePoints.clear();
+    mSampleCount += sampleRange(index, pen.mSampleAngle, toAngle, stepAngle, mSamplePoints);
+    pen.mSampleAngle = std::max(pen.mSampleAngle, toAngle);
+
+    for (const QPointF& pos : mSamplePoints)
+        drawTo(index, pos);
+}
+
+void SpiralEngine::stepCurves(unsigned steps)
+{
+    for (unsigned n = 0; n < steps * mSubSteps; ++n)
+    {
+        mStepper.step(mCenters);
+
+        for (unsigned i = 1; i < size(); ++i)
+        {
+            if (mDraws[i])
+            {
+                drawTo(i, mCenters[i]);
+                ++mSampleCount;
+            }
+        }
+    }
+}
+
+uint64_t SpiralEngine::sampleRange(unsigned index, qreal fromAngle, qreal toAngle, qreal stepAngle, PointList& points) const
+{
+    return sampleRange(mSamplers[index], fromAngle, toAngle, stepAngle, MAX_PIXEL_ERROR, points);
+}
+
+uint64_t SpiralEngine::sampleRange(const CurveSampler& sampler, qreal fromAngle, qreal toAngle, qreal stepAngle,
+                                   qreal maxError, PointList& points)
+{
+    const qreal jerk = sampler.getJerkBound();
+    thread_local PointList batch;
+    uint64_t sampleCount = 0;
+    qreal angle = fromAngle;
+
+    while (angle < toAngle)
+    {
+        // A chord over an angle h deviates at most maxAcceleration * h^2 / 8
+        // from the curve. Over h the acceleration is at most a + jerk * h.
+        // Keeping both a * h^2 and jerk * h^3 below 4 * error bounds the deviation.
+        const qreal remaining = toAngle - angle;
+        const qreal a = sampler.getAcceleration(angle);
+        const qreal h = std::min(a > 0.0 ? std::sqrt(4 * maxError / a) : remaining,
+                                 jerk > 0.0 ? std::cbrt(4 * maxError / jerk) : remaining);
+
+        // Fast circle, calculate the points for a step in one batch.
+        const qreal chunk = std::min(stepAngle, remaining);
+
+        if (h < chunk)
+        {
+            const qreal maxA = a + jerk * chunk;
+            const unsigned count = std::ceil(chunk * std::sqrt(maxA / (8 * maxError)));
+            const qreal sampleAngle = chunk / count;
+            sampler.sample(angle + sampleAngle, sampleAngle, count, batch);
+            points.insert(points.end(), batch.begin(), batch.end());
+            sampleCount += count;
+            angle = (chunk < remaining) ? angle + chunk : toAngle;
+            continue;
+        }
+
+        // Slow circle, a single point may cover many steps.
+        angle = (h < remaining) ? angle + h : toAngle;
+        sampler.sample(angle, 0.0, 1, batch);
+        points.push_back(batch.front());
+        ++sampleCount;
+    }
+
+    return sampleCount;
+}
+
+void SpiralEngine::drawSamples(unsigned index, const PointList& points, uint64_t sampleCount)
+{
+    for (const QPointF& pos : points)
+        drawTo(index, pos);
+
+    mSampleCount += sampleCount;
+}
+
+void SpiralEngine::moveCircles(qreal angle)
+{
+    mEvaluator.evaluate(angle, mCenters);
+
+    for (Pen& pen : mPens)
+        pen.mSampleAngle = angle;
+}
+
+void SpiralEngine::forceDraw()
+{
+    for (unsigned i = 0; i < size(); ++i)
+    {
+        if (mDraws[i])
+            drawTo(i, mCenters[i], true);
+    }
+}
+
+void SpiralEngine::drawTo(unsigned index, const QPointF& pos, bool force)
+{
+    Pen& pen = mPens[index];
+    const QLineF line(pen.mDrawPos, pos);
+
+    if (line.length() >= MIN_DRAW_LENGTH || force)
+    {
+        Q_ASSERT(pen.mPoints);
+        pen.mPoints->push_back(pos);
+        pen.mDrawPos = pos;
+        pen.mDrawnLength += line.length();
+    }
+}
+
+}
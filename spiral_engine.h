@@ -0,0 +1,148 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "curve_sampler.h"
+#include "epicycle_evaluator.h"
+#include "epicycle_stepper.h"
+#include <QColor>
+#include <QPointF>
+#include <QRectF>
+#include <vector>
+
+namespace SpiralFun {
+
+// The circle data and the simulation of the circles rotating around each other.
+// It does not depend on QtQuick, such that spirals can be calculated without a
+// window. Circles in the scene are views on this data.
+class SpiralEngine
+{
+public:
+    static constexpr int MAX_DRAW = 7;
+
+    // Maximum distance (pixels) between the curve and the drawn line.
+    static constexpr qreal MAX_PIXEL_ERROR = 0.25;
+
+    enum class StepMode
+    {
+        // Sample the closed form adapted to the acceleration of the pens.
+        ADAPTIVE,
+
+        // Fixed sub steps that rotate the arms without trigonometric functions.
+        RECURRENCE
+    };
+
+    using PointList = std::vector<QPointF>;
+
+    unsigned size() const { return mDiameters.size(); }
+    bool empty() const { return mDiameters.empty(); }
+    void clear() { resize(0); }
+    void resize(unsigned size);
+    unsigned addCircle(const QPointF& center, int diameter, int speed = 0, int draw = 0, const QColor& color = Qt::white);
+
+    const QPointF& getCenter(unsigned index) const { return mCenters[index]; }
+    qreal getRadius(unsigned index) const { return mDiameters[index] / 2.0; }
+    int getDiameter(unsigned index) const { return mDiameters[index]; }
+    int getSpeed(unsigned index) const { return mSpeeds[index]; }
+    int getDraw(unsigned index) const { return mDraws[index]; }
+    const QColor& getColor(unsigned index) const { return mColors[index]; }
+    void setCenter(unsigned index, const QPointF& center) { mCenters[index] = center; }
+    void setDiameter(unsigned index, int diameter) { mDiameters[index] = diameter; }
+    void setSpeed(unsigned index, int speed) { mSpeeds[index] = speed; }
+    void setDraw(unsigned index, int draw);
+    void setColor(unsigned index, const QColor& color) { mColors[index] = color; }
+    const std::vector<QPointF>& getCenters() const { return mCenters; }
+    const std::vector<int>& getSpeeds() const { return mSpeeds; }
+    bool hasDrawingCircle() const;
+
+    // Put the circles on top of each other, circle 0 at the given center.
+    void resetCenters(const QPointF& center);
+
+    // Rectangle that contains all possible positions of the circles.
+    QRectF getMaxRect() const;
+
+    // Angle of circle 1 after which the drawing circles repeat their curves.
+    // This is 2pi, or a fraction of it when the speeds have a common divisor.
+    qreal getPeriod() const;
+
+    // The curves have k-fold rotational symmetry about the center of circle 0.
+    // The curve drawn in sector m, i.e. between m/k and (m+1)/k of the period,
+    // is the curve from sector 0 rotated by m * getSectorRotation() radians.
+    unsigned getSymmetry() const;
+    qreal getSectorRotation() const;
+
+    // Points drawn by a circle during play are appended to the point list.
+    void setPenPoints(unsigned index, PointList* points);
+    qreal getDrawnLength(unsigned index) const { return mPens[index].mDrawnLength; }
+    void setDrawnLength(unsigned index, qreal drawnLength) { mPens[index].mDrawnLength = drawnLength; }
+
+    void preparePlay(qreal stepAngle, StepMode stepMode = StepMode::ADAPTIVE);
+
+    // Move the circles from one angle of circle 1 to another in a number of
+    // play steps and draw the lines.
+    //
+    // In RECURRENCE mode the steps must have the angle passed to preparePlay.
+    // In ADAPTIVE mode the distance between the drawn points adapts to the local acceleration of
+    // the pen, such that the drawn line deviates less than MAX_PIXEL_ERROR from
+    // the curve. Fast circles get many points per step, slow circles get a
+    // single point for all steps.
+    void advance(qreal fromAngle, qreal toAngle, unsigned steps = 1);
+
+    // Calculate the points of the curve of a drawing circle from one angle to
+    // another, adapted to the acceleration of the pen like advance. This
+    // function may be called from multiple threads. Returns the number of
+    // calculated samples.
+    uint64_t sampleRange(unsigned index, qreal fromAngle, qreal toAngle, qreal stepAngle, PointList& points) const;
+
+    // As sampleRange for any sampler with a maximum deviation of maxError.
+    static uint64_t sampleRange(const CurveSampler& sampler, qreal fromAngle, qreal toAngle, qreal stepAngle,
+                                qreal maxError, PointList& points);
+
+    // Sampler of a drawing circle, valid after preparePlay.
+    const CurveSampler& getSampler(unsigned index) const { return mSamplers[index]; }
+
+    // Draw points calculated by sampleRange.
+    void drawSamples(unsigned index, const PointList& points, uint64_t sampleCount);
+
+    // Move the circles to the given angle without drawing.
+    void moveCircles(qreal angle);
+
+    // Draw the last line to close the curve. It may not have been drawn yet
+    // due to the minimum draw length.
+    void forceDraw();
+
+    // Number of curve positions calculated since preparePlay.
+    uint64_t getSampleCount() const { return mSampleCount; }
+
+private:
+    struct Pen
+    {
+        QPointF mDrawPos;
+        qreal mDrawnLength = 0.0;
+        PointList* mPoints = nullptr;
+
+        // Angle of the last sampled position.
+        qreal mSampleAngle = 0.0;
+    };
+
+    std::vector<int> getArmSpeeds() const;
+    int getSpeedDivisor() const;
+    void sampleCurve(unsigned index, qreal toAngle, qreal stepAngle);
+    void stepCurves(unsigned steps);
+    void drawTo(unsigned index, const QPointF& pos, bool force = false);
+
+    std::vector<int> mDiameters;
+    std::vector<int> mSpeeds;
+    std::vector<int> mDraws;
+    std::vector<QColor> mColors;
+    std::vector<QPointF> mCenters;
+    std::vector<Pen> mPens;
+    EpicycleEvaluator mEvaluator;
+    std::vector<CurveSampler> mSamplers;
+    PointList mSamplePoints;
+    uint64_t mSampleCount = 0;
+    StepMode mStepMode = StepMode::ADAPTIVE;
+    EpicycleStepper mStepper;
+    unsigned mSubSteps = 1;
+};
+
+}
@@ -5,16 +5,60 @@
 #include "exception.h"
 #include "jni_callback.h"
 #include "player.h"
+#include "poster_exporter.h"
+#include "software_rasterizer.h"
 #include "utils.h"
+#include "vector_exporter.h"
 #include <QFile>
 #include <QQmlEngine>
-#include <QQuickItemGrabResult>
 #include <QSGNode>
 
 using namespace std::chrono_literals;
 
 namespace SpiralFun {
 
+namespace {
+// Capacity of a geometry node of a line. New points are added to the last
+// node till it is full.
+constexpr unsigned LINE_NODE_VERTICES = 16384;
+
+// Margin around the spiral on posters and vector files in scene units.
+constexpr qreal POSTER_MARGIN = 20.0;
+
+// Maximum distance between a circle outline and its polygon approximation.
+constexpr qreal CIRCLE_TOLERANCE = 0.25;
+
+// Refresh interval of the scene while flashes are shown.
+constexpr auto FLASH_REFRESH_INTERVAL = 40ms;
+
+// Time without zoom changes after which the visible curves are calculated for
+// the zoom scale.
+constexpr auto ZOOM_SETTLE_TIME = 300ms;
+
+// Polygon of a circle outline. The first segment is repeated, such that the
+// closing vertex gets a join.
+void getCircleOutline(const QPointF& center, qreal radius, std::vector<QPointF>& outline)
+{
+    const int segments = radius > CIRCLE_TOLERANCE ?
+            std::max(8, int(std::ceil(M_PI / std::acos(1.0 - CIRCLE_TOLERANCE / radius)))) : 8;
+    outline.clear();
+
+    for (int i = 0; i <= segments + 1; ++i)
+    {
+        const qreal angle = 2 * M_PI * i / segments;
+        outline.push_back(center + radius * QPointF(std::cos(angle), std::sin(angle)));
+    }
+}
+
+// The vertex color material expects premultiplied colors.
+QSGGeometry::ColoredPoint2D toColoredPoint(const QPointF& p, const QColor& color)
+{
+    const int a = color.alpha();
+    return { float(p.x()), float(p.y()), uchar(color.red() * a / 255), uchar(color.green() * a / 255),
+             uchar(color.blue() * a / 255), uchar(a) };
+}
+}
+
 int SpiralScene::MAX_DIAMETER = 300;
 
 SpiralScene::SpiralScene(QQuickItem *parent) :
@@ -23,12 +67,36 @@ SpiralScene::SpiralScene(QQuickItem *parent) :
     setFlags(ItemHasContents | ItemIsViewport);
     setAntialiasing(true);
     setAcceptTouchEvents(true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+
+    mZoomTimer.setSingleShot(true);
+    mZoomTimer.setInterval(ZOOM_SETTLE_TIME);
+    QObject::connect(&mZoomTimer, &QTimer::timeout, this, [this]{ resampleZoom(); });
+
+    mFlashTimer.setInterval(FLASH_REFRESH_INTERVAL);
+    QObject::connect(&mFlashTimer, &QTimer::timeout, this, [this]{
+            // The last refresh removes the last flash.
+            if (!mFlashPool.isActive())
+                mFlashTimer.stop();
+
+            mUpdateFlashes = true;
+            update();
+        });
 
     // The window size is not yet known at this time. But setting up a scene
     // guarantees there are always circles available.
     setupCircles();
 }
 
+SpiralScene::~SpiralScene()
+{
+    if (mPosterThread)
+        mPosterThread->wait();
+
+    if (mZoomThread)
+        mZoomThread->wait();
+}
+
 void SpiralScene::init()
 {
     if (mInitialized)
@@ -78,6 +146,26 @@ void SpiralScene::setPlayingSpeed(int playingSpeed)
     }
 }
 
+void SpiralScene::setRecurrenceStepping(bool recurrenceStepping)
+{
+    if (recurrenceStepping != mRecurrenceStepping)
+    {
+        mRecurrenceStepping = recurrenceStepping;
+        emit recurrenceSteppingChanged();
+    }
+}
+
+void SpiralScene::setLineRenderer(LineRenderer lineRenderer)
+{
+    if (lineRenderer != mLineRenderer)
+    {
+        mLineRenderer = lineRenderer;
+        mRebuildLines = true;
+        emit lineRendererChanged();
+        update();
+    }
+}
+
 void SpiralScene::setToneDistance(int toneDistance)
 {
     if (toneDistance != mToneDistance)
@@ -110,6 +198,7 @@ void SpiralScene::handleWindowSizeChanged()
 void SpiralScene::setupCircles(const CircleConfigList& config)
 {
     mCircles.clear();
+    mEngine.clear();
 
     for (const auto& c : config)
     {
@@ -160,6 +249,11 @@ void SpiralScene::setNumCircles(int numCircles)
     if (n < mCircles.size())
     {
         mCircles.resize(numCircles);
+        mEngine.resize(numCircles);
+
+        // The outlines of the removed circles are in the circle node.
+        updateCircleOutlines();
+
         if (mCurrentIndex >= mCircles.size())
         {
             setCurrentIndex(mCircles.size() - 1);
@@ -184,18 +278,18 @@ void SpiralScene::setNumCircles(int numCircles)
 SpiralFun::Circle* SpiralScene::addCircle(qreal radius)
 {
     QPointF center = boundingRect().center();
-    if (!mCircles.empty())
+    if (!mEngine.empty())
     {
-        const auto& prevCircle = *mCircles.back();
-        center = prevCircle.getCenter();
-        center.ry() -= prevCircle.getRadius() + radius;
+        const unsigned prev = mEngine.size() - 1;
+        center = mEngine.getCenter(prev);
+        center.ry() -= mEngine.getRadius(prev) + radius;
     }
 
-    auto circle = std::make_unique<SpiralFun::Circle>(this);
+    const unsigned index = mEngine.addCircle(center, std::round(radius * 2));
+    auto circle = std::make_unique<SpiralFun::Circle>(this, index);
     auto* engine = qmlEngine(this);
     engine->setContextForObject(circle.get(), qmlContext(this));
-    circle->setCenter(center);
-    circle->setRadius(radius);
+    circle->syncView();
     QObject::connect(circle.get(), &Circle::diameterChanged, this,
             [this, c=circle.get()](int oldDiameter){ handleDiameterChange(c, oldDiameter); });
     mCircles.push_back(std::move(circle));
@@ -301,10 +395,7 @@ void SpiralScene::setCurrentIndex(unsigned index)
 
 bool SpiralScene::checkPlayRequirement()
 {
-    const auto it = std::find_if(mCircles.begin(), mCircles.end(), [](const auto& c){
-            return c->getDraw(); });
-
-    if (it == mCircles.end())
+    if (!mEngine.hasDrawingCircle())
     {
         emit message("Enable line drawing on at least 1 circle");
         return false;
@@ -331,7 +422,7 @@ void SpiralScene::playSequence(const QVariant& mutations, int sequenceLength, bo
     if (!checkPlayRequirement())
         return;
 
-    mMutationSequence = std::make_unique<MutationSequence>(&mCircles, this);
+    mMutationSequence = std::make_unique<MutationSequence>(&mEngine, this);
     mMutationSequence->setSequenceLength(sequenceLength);
     mMutationSequence->setAddReverseSequence(addReverse);
     mMutationSequence->setMutations(mutations);
@@ -357,6 +448,9 @@ void SpiralScene::playSequence(const QVariant& mutations, int sequenceLength, bo
 
     connect(mMutationSequence.get(), &MutationSequence::sequenceFramePlaying, this, [this]{ emit sequenceFrameChanged(); });
     connect(mMutationSequence.get(), &MutationSequence::sequenceFinished, this, [this](bool success){
+            // The circle settings have been restored in the engine.
+            resetCircles();
+            emit currentCircleChanged();
             setPlayState(DONE_PLAYING);
             mMutationSequence = nullptr;
 
@@ -376,20 +470,38 @@ void SpiralScene::playSequenceFrame()
 void SpiralScene::doPlay(std::unique_ptr<Recorder> recorder)
 {
     mStats = {};
+    mCurveProgress = 0.0;
+    emit curveProgressChanged();
     setCurrentCircleFocus(false);
 
+    for (auto& circle : mCircles)
+        circle->preparePlay();
+
     // Music is only supported in playing state.
     std::unique_ptr<MusicGenerator> musicGenerator;
 
     if (mMusicGeneration && mPlayState == PLAYING)
-        musicGenerator = std::make_unique<MusicGenerator>(mCircles, mToneDistance, MAX_PLAYING_SPEED - mPlayingSpeed + MIN_PLAYING_SPEED, this);
+        musicGenerator = std::make_unique<MusicGenerator>(mEngine, mToneDistance, MAX_PLAYING_SPEED - mPlayingSpeed + MIN_PLAYING_SPEED, this);
 
-    mPlayer = std::make_unique<Player>(mCircles, std::move(musicGenerator));
+    mPlayer = std::make_unique<Player>(mEngine, std::move(musicGenerator));
+    mPlayer->setStepMode(mRecurrenceStepping ? SpiralEngine::StepMode::RECURRENCE : SpiralEngine::StepMode::ADAPTIVE);
+
+    if (window())
+        mPlayer->setFrameWindow(window());
 
     QObject::connect(mPlayer.get(), &Player::refreshScene, this, [this]{ update(); });
+    QObject::connect(mPlayer.get(), &Player::circlesMoved, this, [this]{
+            for (auto& circle : mCircles)
+                circle->updatePosition();
+        });
     QObject::connect(mPlayer.get(), &Player::angleChanged, this, [this]{ emit playAngleChanged(); });
+    QObject::connect(mPlayer.get(), &Player::progress, this, [this](qreal fraction){
+            mCurveProgress = fraction;
+            emit curveProgressChanged();
+        });
     QObject::connect(mPlayer.get(), &Player::done, this, [this](const Player::Stats& stats){
             mStats.mPlayerStats = stats;
+            mStats.mSampleCount = mEngine.getSampleCount();
             removeCirclesFromScene();
 
             if (mPlayState == RECORDING)
@@ -440,21 +552,159 @@ void SpiralScene::showSpiralStats()
         return;
     }
 
-    const QString statMsg = QString(
+    QString statMsg = QString(
         "| Statistic      | Value |\n"
         "| :------------- | ----: |\n"
         "| Creation steps | %1    |\n"
         "| Creation time  | %2 s  |\n"
         "| Step time      | %3 ms |\n"
-        "| Line segments  | %4    |")
+        "| Line segments  | %4    |\n"
+        "| Geometry nodes | %5    |\n"
+        "| Vertices       | %6    |\n"
+        "| Draw calls     | %7    |\n"
+        "| Curve samples  | %8    |\n"
+        "| Skipped angle  | %9 %  |\n"
+        "| Line history   | %10 KB |")
             .arg(mStats.mPlayerStats.mCycles)
             .arg(qreal(mStats.mPlayerStats.mPlayTime / 1000.0ms))
             .arg(qreal(mStats.mPlayerStats.mPlayTime / (qreal)mStats.mPlayerStats.mCycles / 1000.0us))
-            .arg(mStats.mLineSegmentCount);
+            .arg(mStats.mLineSegmentCount)
+            .arg(mStats.mNodeCount)
+            .arg(mStats.mVertexCount)
+            .arg(mStats.mLineDrawCalls)
+            .arg(mStats.mSampleCount)
+            .arg(std::round(mStats.mPlayerStats.mSkippedFraction * 100))
+            .arg(getLineHistoryMemoryUsage() / 1024);
+
+    const auto& recorderStats = mStats.mPlayerStats.mRecorderStats;
+
+    if (recorderStats.mFrameCount > 0)
+    {
+        statMsg += QString(
+            "\n| Recorded frames | %1 |\n"
+            "| Recording rate  | %2 fps |\n"
+            "| Max frame queue | %3 |\n"
+            "| Recording stall | %4 ms |\n"
+            "| Frame buffers   | %5 |")
+                .arg(recorderStats.mFrameCount)
+                .arg(recorderStats.mFramesPerSecond, 0, 'f', 1)
+                .arg(recorderStats.mMaxQueueDepth)
+                .arg(recorderStats.mStallTime.count())
+                .arg(recorderStats.mFrameAllocations);
+    }
 
     emit message(statMsg);
 }
 
+// Called from updatePaintNode, as the nodes belong to the render thread. The
+// count is an estimate of what the scene graph renderer does. Line strips cannot
+// be merged, so each line strip node is a draw call. The triangle strip nodes
+// share one material and can be merged into a single draw call.
+void SpiralScene::updateLineDrawCalls()
+{
+    uint32_t drawCalls = 0;
+
+    if (mBatchRoot && mBatchRoot->childCount() > 0)
+        drawCalls = mLineRenderer == LINE_RENDERER_TRIANGLES ? 1 : mBatchRoot->childCount();
+
+    for (const auto& [_, line] : mLines)
+    {
+        if (line.mRoot)
+            drawCalls += line.mRoot->childCount();
+    }
+
+    mStats.mLineDrawCalls = drawCalls;
+}
+
+std::size_t SpiralScene::getLineHistoryMemoryUsage() const
+{
+    std::size_t bytes = 0;
+
+    for (const auto& [_, line] : mLines)
+        bytes += line.mHistory.getMemoryUsage();
+
+    return bytes;
+}
+
+void SpiralScene::renderLines(SoftwareRasterizer& rasterizer) const
+{
+    for (const auto& [_, line] : mLines)
+    {
+        rasterizer.beginPolyline(line.mColor, line.mLineWidth);
+        line.mHistory.forEach([&rasterizer](const QPointF& p){ rasterizer.lineTo(p); });
+
+        // The first pending point is the last point of the history.
+        for (std::size_t i = line.mHistory.empty() ? 0 : 1; i < line.mLinePoints.size(); ++i)
+            rasterizer.lineTo(line.mLinePoints[i]);
+
+        rasterizer.endPolyline();
+    }
+}
+
+// Draws the points added since the previous call, continuing from the last point
+// drawn. Blocks of the history before that point are skipped.
+void SpiralScene::renderNewLinePoints(SoftwareRasterizer& rasterizer, LineRenderState& state) const
+{
+    if (state.mLineGeneration != mLineGeneration)
+    {
+        // Same background as the scene in main.qml
+        rasterizer.clear(Qt::black);
+        state.mDrawnPoints.clear();
+        state.mLineGeneration = mLineGeneration;
+    }
+
+    for (const auto& [object, line] : mLines)
+    {
+        // The first pending point is the last point of the history.
+        const std::size_t historySize = line.mHistory.size();
+        const std::size_t firstPending = line.mHistory.empty() ? 0 : 1;
+        const std::size_t pendingSize = line.mLinePoints.size() > firstPending ? line.mLinePoints.size() - firstPending : 0;
+        const std::size_t size = historySize + pendingSize;
+        std::size_t& drawnPoints = state.mDrawnPoints[object];
+        const std::size_t first = drawnPoints > 0 ? drawnPoints - 1 : 0;
+
+        if (size < first + 2)
+            continue;
+
+        rasterizer.beginPolyline(line.mColor, line.mLineWidth);
+
+        if (first < historySize)
+            line.mHistory.forEachFrom(first, [&rasterizer](const QPointF& p){ rasterizer.lineTo(p); });
+
+        for (std::size_t i = std::max(first, historySize) - historySize + firstPending; i < line.mLinePoints.size(); ++i)
+            rasterizer.lineTo(line.mLinePoints[i]);
+
+        rasterizer.endPolyline();
+        drawnPoints = size;
+    }
+}
+
+void SpiralScene::renderCircles(SoftwareRasterizer& rasterizer) const
+{
+    std::vector<QPointF> outline;
+
+    for (const auto& circle : mCircles)
+    {
+        if (!circle->isVisible())
+            continue;
+
+        getCircleOutline(circle->getCenter(), circle->getRadius(), outline);
+        rasterizer.drawPolyline(outline.data(), outline.data() + outline.size(), circle->getColor(), circle->getPenWidth());
+    }
+}
+
+QImage SpiralScene::renderImage(const QRect& cutRect, qreal scale) const
+{
+    QImage image(cutRect.size(), QImage::Format_ARGB32_Premultiplied);
+    SoftwareRasterizer rasterizer(image);
+    rasterizer.setTransform(scale, cutRect.topLeft());
+
+    // Same background as the scene in main.qml
+    rasterizer.clear(Qt::black);
+    renderLines(rasterizer);
+    return image;
+}
+
 void SpiralScene::record(Recorder::Format format)
 {
     const qreal r = mCircles.back()->getRadius();
@@ -521,6 +771,11 @@ void SpiralScene::setPlayState(PlayState state)
 
     mPlayState = state;  
     emit playStateChanged();
+
+    if (state == DONE_PLAYING)
+        mZoomTimer.start();
+    else
+        clearZoomDetail();
 }
 
 void SpiralScene::setShareMode(ShareMode shareMode)
@@ -547,16 +802,10 @@ void SpiralScene::resetCircles()
     if (mCircles.empty())
         return;
 
-    QPointF center = boundingRect().center();
-    mCircles[0]->setCenter(center);
+    mEngine.resetCenters(boundingRect().center());
 
-    for (unsigned i = 1; i < mCircles.size(); ++i)
-    {
-        auto& circle = mCircles[i];
-        auto& prev = mCircles[i - 1];
-        center.ry() -= prev->getRadius() + circle->getRadius();
-        circle->setCenter(center);
-    }
+    for (auto& circle : mCircles)
+        circle->syncView();
 }
 
 void SpiralScene::resetScene()
@@ -564,8 +813,11 @@ void SpiralScene::resetScene()
     for (auto& [_, line] : mLines)
         line.mLinePoints.clear();
 
+    ++mLineGeneration;
     removeCirclesFromScene();
     mClearScene = true;
+    clearZoomDetail();
+    mFlashPool.clear();
     resetCircles();
     addCirclesToScene();
     mScaleFactor = 1.0;
@@ -599,9 +851,15 @@ ScopedLine SpiralScene::addLine(QObject* object, const QColor& color, int lineWi
     Line& line = mLines[object];
     line.mColor = color;
     line.mLineWidth = lineWidth;
+    line.mTessellator.setWidth(lineWidth);
     line.mLinePoints.reserve(256);
     line.mLinePoints.push_back(startPoint);
-    return std::forward<ScopedLine>(ScopedLine(&line, [this, object]{ mLines.erase(object); }));
+    ++mLineGeneration;
+
+    return std::forward<ScopedLine>(ScopedLine(&line, [this, object]{
+            mLines.erase(object);
+            ++mLineGeneration;
+        }));
 }
 
 QSGNode* SpiralScene::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
@@ -614,34 +872,79 @@ QSGNode* SpiralScene::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
     if (mClearScene)
     {
         for (auto& [_, line] : mLines)
+        {
             line.mRoot = nullptr;
+            line.mNode = nullptr;
+            line.mNodeVertexCount = 0;
+            line.mMaterial = nullptr;
+            line.mTessellator.reset();
+        }
 
+        mBatchRoot = nullptr;
+        mLineBatches.clear();
+        mLinesNode = nullptr;
+        mZoomRoot = nullptr;
+        mCircleNode = nullptr;
+        mUpdateCircles = true;
+        mFlashNode = nullptr;
         delete sceneRoot;
         sceneRoot = new QSGNode;
         mSceneRect = {};
         mClearScene = false;
     }
 
+    // The lines are hidden while the lines calculated for the zoom scale are shown.
+    if (!mLinesNode)
+    {
+        mLinesNode = new QSGOpacityNode;
+        mLinesNode->setFlag(QSGNode::OwnedByParent);
+        sceneRoot->appendChildNode(mLinesNode);
+    }
+
+    if (mRebuildLines)
+    {
+        rebuildLineNodes(mLinesNode);
+        mRebuildLines = false;
+    }
+
+    if (mZoomDetailChanged)
+    {
+        updateZoomNodes(sceneRoot);
+        mZoomDetailChanged = false;
+    }
+
     for (auto& [_, line] : mLines)
     {
         if (line.mLinePoints.size() < 2)
             continue;
 
-        if (!line.mRoot)
-        {
-            line.mRoot = new QSGNode;
-            line.mRoot->setFlag(QSGNode::OwnedByParent);
-            sceneRoot->appendChildNode(line.mRoot);
-        }
+        addLinePoints(mLinesNode, line, line.mLinePoints);
+        mStats.mLineSegmentCount += line.mLinePoints.size() - 1;
+        mStats.mLinePointsSum += line.mLinePoints.size();
+
+        // The first point was already added as the last point of the previous node.
+        const auto* firstNew = line.mLinePoints.data() + (line.mHistory.empty() ? 0 : 1);
+        line.mHistory.append(firstNew, line.mLinePoints.data() + line.mLinePoints.size());
 
-        auto* node = createLineNode(line);
-        node->setFlag(QSGNode::OwnedByParent);
-        line.mRoot->appendChildNode(node);
         QPointF p = line.mLinePoints.back();
         line.mLinePoints.clear();
         line.mLinePoints.push_back(p);
     }
 
+    updateLineDrawCalls();
+
+    if (mUpdateCircles)
+    {
+        updateCircleNode(sceneRoot);
+        mUpdateCircles = false;
+    }
+
+    if (mUpdateFlashes)
+    {
+        updateFlashNode(sceneRoot);
+        mUpdateFlashes = false;
+    }
+
     if (mPlayState == PLAYING_SEQUENCE)
     {
         mDoRender = false;
@@ -651,29 +954,499 @@ QSGNode* SpiralScene::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
     return sceneRoot;
 }
 
-QSGNode* SpiralScene::createLineNode(Line& line)
+void SpiralScene::rebuildLineNodes(QSGNode* sceneRoot)
+{
+    for (auto& [_, line] : mLines)
+    {
+        if (line.mRoot)
+        {
+            sceneRoot->removeChildNode(line.mRoot);
+            delete line.mRoot;
+        }
+
+        line.mRoot = nullptr;
+        line.mNode = nullptr;
+        line.mNodeVertexCount = 0;
+        line.mMaterial = nullptr;
+        line.mTessellator.reset();
+    }
+
+    if (mBatchRoot)
+    {
+        sceneRoot->removeChildNode(mBatchRoot);
+        delete mBatchRoot;
+        mBatchRoot = nullptr;
+    }
+
+    mLineBatches.clear();
+    mStats.mNodeCount = 0;
+    mStats.mVertexCount = 0;
+
+    for (auto& [_, line] : mLines)
+    {
+        if (line.mHistory.size() < 2)
+            continue;
+
+        std::vector<QPointF> points;
+        points.reserve(line.mHistory.size());
+        line.mHistory.forEach([&points](const QPointF& p){ points.push_back(p); });
+        addLinePoints(sceneRoot, line, points);
+    }
+
+    qDebug() << "Line nodes rebuilt, renderer:" << mLineRenderer << "nodes:" << mStats.mNodeCount;
+}
+
+void SpiralScene::addLinePoints(QSGNode* sceneRoot, Line& line, const std::vector<QPointF>& points)
+{
+    switch (mLineRenderer)
+    {
+    case LINE_RENDERER_NODES:
+        addLineNodePoints(sceneRoot, line, points);
+        break;
+    case LINE_RENDERER_BATCHED:
+        addBatchedLinePoints(sceneRoot, line, points);
+        break;
+    case LINE_RENDERER_TRIANGLES:
+        addTessellatedLinePoints(sceneRoot, line, points);
+        break;
+    }
+}
+
+void SpiralScene::addLineNodePoints(QSGNode* sceneRoot, Line& line, const std::vector<QPointF>& points)
+{
+    if (!line.mRoot)
+    {
+        line.mRoot = new QSGNode;
+        line.mRoot->setFlag(QSGNode::OwnedByParent);
+        sceneRoot->appendChildNode(line.mRoot);
+    }
+
+    // The first point is the last vertex of the current node, or starts the line.
+    if (!line.mNode)
+        createLineNode(line, points[0]);
+
+    std::size_t i = 1;
+
+    while (i < points.size())
+    {
+        if (line.mNodeVertexCount == LINE_NODE_VERTICES)
+            createLineNode(line, points[i - 1]);
+
+        auto* vertices = line.mNode->geometry()->vertexDataAsPoint2D();
+        const std::size_t count = std::min(points.size() - i, std::size_t(LINE_NODE_VERTICES - line.mNodeVertexCount));
+
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            const QPointF& p = points[i + n];
+            vertices[line.mNodeVertexCount + n].set(p.x(), p.y());
+            updateSceneRect(p);
+        }
+
+        line.mNodeVertexCount += count;
+        i += count;
+
+        // The unused vertices repeat the last point, such that they draw nothing.
+        const auto& last = vertices[line.mNodeVertexCount - 1];
+        std::fill(vertices + line.mNodeVertexCount, vertices + LINE_NODE_VERTICES, last);
+
+        line.mNode->markDirty(QSGNode::DirtyGeometry);
+    }
+}
+
+void SpiralScene::createLineNode(Line& line, const QPointF& startPoint)
 {
     auto* node = new QSGGeometryNode;
-    auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), line.mLinePoints.size());
+    auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), LINE_NODE_VERTICES);
     geometry->setLineWidth(line.mLineWidth);
     geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+    geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
     node->setGeometry(geometry);
     node->setFlag(QSGNode::OwnsGeometry);
+    node->setFlag(QSGNode::OwnedByParent);
     line.setNodeMaterial(node);
 
     auto* vertices = geometry->vertexDataAsPoint2D();
-    for (int unsigned i = 0; i < line.mLinePoints.size(); ++i)
+    vertices[0].set(startPoint.x(), startPoint.y());
+    std::fill(vertices + 1, vertices + LINE_NODE_VERTICES, vertices[0]);
+    updateSceneRect(startPoint);
+
+    line.mRoot->appendChildNode(node);
+    line.mNode = node;
+    line.mNodeVertexCount = 1;
+
+    ++mStats.mNodeCount;
+    mStats.mVertexCount += LINE_NODE_VERTICES;
+}
+
+// All lines with the same width share a line strip with per vertex colors. The
+// points of a line are surrounded by transparent copies of the first and last
+// point. The segments that connect the lines in the strip are transparent.
+void SpiralScene::addBatchedLinePoints(QSGNode* sceneRoot, const Line& line, const std::vector<QPointF>& points)
+{
+    createBatchRoot(sceneRoot);
+    LineBatch& batch = mLineBatches[line.mLineWidth];
+    const QPointF& first = points.front();
+    const QPointF& last = points.back();
+
+    appendBatchVertex(batch, line.mLineWidth, toColoredPoint(first, Qt::transparent));
+
+    for (const QPointF& p : points)
     {
-        const QPointF& p = line.mLinePoints[i];
-        vertices[i].set(p.x(), p.y());
+        appendBatchVertex(batch, line.mLineWidth, toColoredPoint(p, line.mColor));
         updateSceneRect(p);
     }
 
-    node->markDirty(QSGNode::DirtyGeometry);
-    mStats.mLineSegmentCount += line.mLinePoints.size() - 1;
-    mStats.mLinePointsSum += line.mLinePoints.size();
-    ++mStats.mLineCount;
-    return node;
+    appendBatchVertex(batch, line.mLineWidth, toColoredPoint(last, Qt::transparent));
+    fillBatchTail(batch);
+}
+
+// The strips of all lines are joined into a single triangle strip by repeating
+// the last vertex of a strip and the first vertex of the next strip. This gives
+// degenerate triangles.
+void SpiralScene::addTessellatedLinePoints(QSGNode* sceneRoot, Line& line, const std::vector<QPointF>& points)
+{
+    mStripVertices.clear();
+    line.mTessellator.append(points.data(), points.data() + points.size(), mStripVertices);
+
+    for (const QPointF& p : points)
+        updateSceneRect(p);
+
+    if (mStripVertices.empty())
+        return;
+
+    createBatchRoot(sceneRoot);
+    LineBatch& batch = mLineBatches[0];
+
+    if (batch.mNode && batch.mVertexCount > 0)
+    {
+        const auto previous = batch.mNode->geometry()->vertexDataAsColoredPoint2D()[batch.mVertexCount - 1];
+        appendBatchVertex(batch, 0, previous);
+        appendBatchVertex(batch, 0, toColoredPoint(mStripVertices.front(), line.mColor));
+    }
+
+    for (const QPointF& p : mStripVertices)
+        appendBatchVertex(batch, 0, toColoredPoint(p, line.mColor));
+
+    fillBatchTail(batch);
+}
+
+void SpiralScene::createBatchRoot(QSGNode* sceneRoot)
+{
+    if (!mBatchRoot)
+    {
+        mBatchRoot = new QSGNode;
+        mBatchRoot->setFlag(QSGNode::OwnedByParent);
+        sceneRoot->appendChildNode(mBatchRoot);
+    }
+}
+
+// The unused vertices repeat the last vertex, such that they draw nothing.
+void SpiralScene::fillBatchTail(LineBatch& batch)
+{
+    auto* vertices = batch.mNode->geometry()->vertexDataAsColoredPoint2D();
+    std::fill(vertices + batch.mVertexCount, vertices + LINE_NODE_VERTICES, vertices[batch.mVertexCount - 1]);
+    batch.mNode->markDirty(QSGNode::DirtyGeometry);
+}
+
+void SpiralScene::appendBatchVertex(LineBatch& batch, int lineWidth, const QSGGeometry::ColoredPoint2D& vertex)
+{
+    if (!batch.mNode || batch.mVertexCount == LINE_NODE_VERTICES)
+    {
+        const QSGGeometry::ColoredPoint2D* last = nullptr;
+
+        if (batch.mNode)
+        {
+            last = batch.mNode->geometry()->vertexDataAsColoredPoint2D() + LINE_NODE_VERTICES - 1;
+            batch.mNode->markDirty(QSGNode::DirtyGeometry);
+        }
+
+        createBatchNode(batch, lineWidth);
+        auto* vertices = batch.mNode->geometry()->vertexDataAsColoredPoint2D();
+
+        // Continue a strip that did not fit in the previous node. A triangle
+        // strip continues from the last two vertices, a line from the last vertex.
+        if (last && mLineRenderer == LINE_RENDERER_TRIANGLES)
+        {
+            vertices[batch.mVertexCount++] = last[-1];
+            vertices[batch.mVertexCount++] = last[0];
+        }
+        else if (last && last->a != 0)
+        {
+            vertices[batch.mVertexCount++] = *last;
+        }
+    }
+
+    batch.mNode->geometry()->vertexDataAsColoredPoint2D()[batch.mVertexCount++] = vertex;
+}
+
+void SpiralScene::createBatchNode(LineBatch& batch, int lineWidth)
+{
+    auto* node = new QSGGeometryNode;
+    auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), LINE_NODE_VERTICES);
+
+    if (mLineRenderer == LINE_RENDERER_TRIANGLES)
+    {
+        geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+    }
+    else
+    {
+        geometry->setLineWidth(lineWidth);
+        geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+    }
+
+    geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+
+    if (batch.mMaterial)
+    {
+        node->setMaterial(batch.mMaterial);
+    }
+    else
+    {
+        batch.mMaterial = new LineVertexColorMaterial;
+        node->setMaterial(batch.mMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    node->setFlag(QSGNode::OwnedByParent);
+    mBatchRoot->appendChildNode(node);
+
+    batch.mNode = node;
+    batch.mVertexCount = 0;
+
+    ++mStats.mNodeCount;
+    mStats.mVertexCount += LINE_NODE_VERTICES;
+}
+
+void SpiralScene::resampleZoom()
+{
+    if (mPlayState != DONE_PLAYING || !mPlayer || scale() <= 1.0)
+    {
+        clearZoomDetail();
+        return;
+    }
+
+    if (mZoomThread && mZoomThread->isRunning())
+    {
+        mZoomPending = true;
+        return;
+    }
+
+    if (mZoomThread)
+        mZoomThread->wait();
+
+    const QRectF visibleRect = mapRectFromScene(QRectF(0, 0, window()->width(), window()->height()));
+    auto resampler = std::make_shared<ZoomResampler>(visibleRect, scale(), mPlayer->getAngle());
+
+    for (const auto& [object, line] : mLines)
+    {
+        const auto index = findCircle(qobject_cast<const Circle*>(object));
+
+        if (index && mEngine.getDraw(*index))
+            resampler->addLine(mEngine.getSampler(*index), line.mColor, line.mLineWidth);
+    }
+
+    const unsigned generation = ++mZoomGeneration;
+    QThread* thread = QThread::create([resampler]{ resampler->resample(); });
+    mZoomThread.reset(thread);
+    QObject::connect(thread, &QThread::finished, this,
+        [this, resampler, generation]{
+            if (mZoomPending)
+            {
+                mZoomPending = false;
+                mZoomTimer.start();
+                return;
+            }
+
+            if (generation != mZoomGeneration)
+                return;
+
+            mZoomDetail = resampler;
+            mZoomDetailChanged = true;
+            update();
+        },
+        Qt::SingleShotConnection);
+
+    thread->start();
+}
+
+// Results of a running resampler are discarded.
+void SpiralScene::clearZoomDetail()
+{
+    ++mZoomGeneration;
+    mZoomPending = false;
+
+    if (mZoomDetail)
+    {
+        mZoomDetail = nullptr;
+        mZoomDetailChanged = true;
+        update();
+    }
+}
+
+// The lines of the zoom detail have a single vertex colored triangle strip each,
+// all with the same material.
+void SpiralScene::updateZoomNodes(QSGNode* sceneRoot)
+{
+    if (mZoomRoot)
+    {
+        sceneRoot->removeChildNode(mZoomRoot);
+        delete mZoomRoot;
+        mZoomRoot = nullptr;
+    }
+
+    mLinesNode->setOpacity(mZoomDetail ? 0.0 : 1.0);
+
+    if (!mZoomDetail)
+        return;
+
+    mZoomRoot = new QSGNode;
+    mZoomRoot->setFlag(QSGNode::OwnedByParent);
+    sceneRoot->insertChildNodeAfter(mZoomRoot, mLinesNode);
+    LineVertexColorMaterial* material = nullptr;
+
+    for (const auto& line : mZoomDetail->getLines())
+    {
+        if (line.mStrip.empty())
+            continue;
+
+        auto* node = new QSGGeometryNode;
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), line.mStrip.size());
+        geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+        auto* vertices = geometry->vertexDataAsColoredPoint2D();
+
+        for (const QPointF& p : line.mStrip)
+            *vertices++ = toColoredPoint(p, line.mColor);
+
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+
+        if (material)
+        {
+            node->setMaterial(material);
+        }
+        else
+        {
+            material = new LineVertexColorMaterial;
+            node->setMaterial(material);
+            node->setFlag(QSGNode::OwnsMaterial);
+        }
+
+        node->setFlag(QSGNode::OwnedByParent);
+        mZoomRoot->appendChildNode(node);
+    }
+}
+
+void SpiralScene::updateCircleOutlines()
+{
+    mUpdateCircles = true;
+    update();
+}
+
+// The outlines of all circles are tessellated into a single vertex colored
+// triangle strip, drawn on top of the lines.
+void SpiralScene::updateCircleNode(QSGNode* sceneRoot)
+{
+    if (!mCircleNode)
+    {
+        mCircleNode = new QSGGeometryNode;
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        mCircleNode->setGeometry(geometry);
+        mCircleNode->setFlag(QSGNode::OwnsGeometry);
+        mCircleNode->setMaterial(new LineVertexColorMaterial);
+        mCircleNode->setFlag(QSGNode::OwnsMaterial);
+        mCircleNode->setFlag(QSGNode::OwnedByParent);
+        sceneRoot->appendChildNode(mCircleNode);
+    }
+
+    mCircleVertices.clear();
+    LineTessellator tessellator;
+    std::vector<QPointF> outline;
+
+    for (const auto& circle : mCircles)
+    {
+        if (!circle->isVisible())
+            continue;
+
+        getCircleOutline(circle->getCenter(), circle->getRadius(), outline);
+        mStripVertices.clear();
+        tessellator.reset();
+        tessellator.setWidth(circle->getPenWidth());
+        tessellator.append(outline.data(), outline.data() + outline.size(), mStripVertices);
+
+        if (mStripVertices.empty())
+            continue;
+
+        if (!mCircleVertices.empty())
+        {
+            mCircleVertices.push_back(mCircleVertices.back());
+            mCircleVertices.push_back(toColoredPoint(mStripVertices.front(), circle->getColor()));
+        }
+
+        for (const QPointF& p : mStripVertices)
+            mCircleVertices.push_back(toColoredPoint(p, circle->getColor()));
+    }
+
+    QSGGeometry* geometry = mCircleNode->geometry();
+
+    if (geometry->vertexCount() != int(mCircleVertices.size()))
+        geometry->allocate(mCircleVertices.size());
+
+    std::copy(mCircleVertices.begin(), mCircleVertices.end(), geometry->vertexDataAsColoredPoint2D());
+    mCircleNode->markDirty(QSGNode::DirtyGeometry);
+}
+
+void SpiralScene::addFlash(const QPointF& center, const QColor& color)
+{
+    mFlashPool.add(center, color);
+    mUpdateFlashes = true;
+    update();
+
+    if (!mFlashTimer.isActive())
+        mFlashTimer.start();
+}
+
+// The flashes are drawn on top of the circles. The geometry has a fixed size.
+void SpiralScene::updateFlashNode(QSGNode* sceneRoot)
+{
+    if (!mFlashNode)
+    {
+        mFlashNode = new QSGGeometryNode;
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), FlashPool::VERTEX_COUNT);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        mFlashNode->setGeometry(geometry);
+        mFlashNode->setFlag(QSGNode::OwnsGeometry);
+        mFlashNode->setMaterial(new LineVertexColorMaterial);
+        mFlashNode->setFlag(QSGNode::OwnsMaterial);
+        mFlashNode->setFlag(QSGNode::OwnedByParent);
+        sceneRoot->appendChildNode(mFlashNode);
+    }
+
+    mFlashPool.writeVertices(mFlashNode->geometry()->vertexDataAsColoredPoint2D());
+    mFlashNode->markDirty(QSGNode::DirtyGeometry);
+}
+
+// The last circle is drawn on top. A circle is hit within its selected outline.
+std::optional<unsigned> SpiralScene::findCircleAt(const QPointF& p) const
+{
+    for (unsigned i = mCircles.size(); i-- > 0;)
+    {
+        const auto& circle = mCircles[i];
+
+        if (!circle->isVisible())
+            continue;
+
+        const qreal reach = circle->getRadius() + Circle::SELECT_PEN_WIDTH / 2.0;
+
+        if (QLineF(circle->getCenter(), p).length() <= reach)
+            return i;
+    }
+
+    return {};
 }
 
 void SpiralScene::updateSceneRect(const QPointF& p)
@@ -698,6 +1471,20 @@ void SpiralScene::updateSceneRect(const QPointF& p)
         mSceneRect.setBottom(y);
 }
 
+void SpiralScene::mousePressEvent(QMouseEvent* event)
+{
+    const auto index = findCircleAt(event->position());
+
+    if (!index)
+    {
+        event->ignore();
+        return;
+    }
+
+    selectCircle(mCircles[*index].get());
+    event->accept();
+}
+
 void SpiralScene::touchEvent(QTouchEvent* event)
 {
     switch (event->type())
@@ -715,6 +1502,13 @@ void SpiralScene::touchEvent(QTouchEvent* event)
     }
 
     QTouchEvent* touch = static_cast<QTouchEvent*>(event);
+
+    if (event->type() == QEvent::TouchBegin && touch->points().size() == 1)
+    {
+        if (const auto index = findCircleAt(touch->points()[0].position()))
+            selectCircle(mCircles[*index].get());
+    }
+
     if (touch->points().size() == 2)
     {
         const QEventPoint& p1 = touch->points()[0];
@@ -731,6 +1525,12 @@ void SpiralScene::touchEvent(QTouchEvent* event)
         }
 
         setScale(mScaleFactor * currentScaleFactor);
+
+        // Zooming out shows parts of the lines that were not calculated for the zoom scale.
+        if (mZoomDetail && scale() < mZoomDetail->getScale())
+            clearZoomDetail();
+
+        mZoomTimer.start();
     }
 
     event->accept();
@@ -761,8 +1561,9 @@ bool SpiralScene::saveImage(const QRectF cutRect, const QString subDir, const QS
         return false;
     }
 
+    // A still image is grabbed from the window, as rendered on the GPU.
     const QRectF grabRect = cutRect.isNull() ? mSceneRect : cutRect;
-    mSceneGrabber = createSceneGrabber(grabRect);
+    mSceneGrabber = std::make_unique<SceneGrabber>(this, grabRect);
     const bool grabbed = mSceneGrabber->grabScene(
         [this, fileName, baseFileName, savedCallback](const QImage& img){
             if (img.save(fileName))
@@ -826,7 +1627,7 @@ void SpiralScene::shareImage()
 void SpiralScene::shareMedia()
 {
     Q_ASSERT(!mShareMediaUri.isEmpty());
-    SpiralConfig cfg(mCircles, mDefaultCircleRadius);
+    SpiralConfig cfg(mEngine, mDefaultCircleRadius);
     const QString configAppUri = cfg.getConfigAppUri();
 
     QString mimeType;
@@ -900,7 +1701,7 @@ void SpiralScene::handleReceivedAndroidIntent(const QString& uri)
 {
     stop();
 
-    SpiralConfig cfg(mCircles, mDefaultCircleRadius);
+    SpiralConfig cfg(mEngine, mDefaultCircleRadius);
     try {
         CircleConfigList circleCfg = cfg.decodeConfigAppUri(uri);
         if (!circleCfg.empty())
@@ -912,38 +1713,156 @@ void SpiralScene::handleReceivedAndroidIntent(const QString& uri)
     }
 }
 
-void SpiralScene::saveConfig()
+void SpiralScene::savePoster(int size)
 {
-    const auto pixelRatio = window()->effectiveDevicePixelRatio();
-    const auto cfgSize = CFG_IMAGE_SIZE / pixelRatio;
-    const QSize imageSize = size().scaled(cfgSize, cfgSize, Qt::KeepAspectRatioByExpanding).toSize();
-    auto grabResult = grabToImage(imageSize);
-
-    if (!grabResult)
+    if (mPosterThread && mPosterThread->isRunning())
     {
-        emit message("Failed to grab image.");
+        emit message("Poster is being saved.");
         return;
     }
 
-    QObject::connect(grabResult.get(), &QQuickItemGrabResult::ready, this,
-        [this, grabResult]{
-            const QImage img = grabResult->image();
-            const QImage thumbnail = Utils::createThumbnail(img, size(), mSceneRect, CFG_IMAGE_SIZE);
-            SpiralConfig cfg(mCircles, mDefaultCircleRadius);
+    const QString baseFileName = Utils::createPictureFileName("_poster", "png");
+    const QString fileName = getNewPictureFilePath(baseFileName);
+
+    if (fileName.isEmpty())
+        return;
+
+    const QRectF posterRect = mSceneRect.adjusted(-POSTER_MARGIN, -POSTER_MARGIN, POSTER_MARGIN, POSTER_MARGIN);
+    const QSize posterSize = posterRect.size().scaled(size, size, Qt::KeepAspectRatio).toSize();
+
+    // Copy the lines, such that the poster can be rendered in the background.
+    auto exporter = std::make_shared<PosterExporter>(posterRect, posterSize, Qt::black);
+
+    for (const auto& [_, line] : mLines)
+    {
+        exporter->addLine(line.mColor, line.mLineWidth);
+        line.mHistory.forEach([&exporter](const QPointF& p){ exporter->addPoint(p); });
+
+        for (std::size_t i = line.mHistory.empty() ? 0 : 1; i < line.mLinePoints.size(); ++i)
+            exporter->addPoint(line.mLinePoints[i]);
+    }
+
+    auto error = std::make_shared<QString>();
+    QThread* thread = QThread::create([exporter, fileName, error]{
+        try {
+            exporter->save(fileName);
+        } catch (RuntimeException& e) {
+            *error = e.msg();
+        }
+    });
 
-            try {
-                cfg.save(thumbnail);
-                emit statusUpdate("Config saved");
-            } catch (RuntimeException& e) {
-                emit message(e.msg());
+    mPosterThread.reset(thread);
+    QObject::connect(thread, &QThread::finished, this,
+        [this, exporter, error, fileName, baseFileName]{
+            if (!error->isEmpty())
+            {
+                emit message(*error);
+                return;
             }
-        });
+
+            const auto& stats = exporter->getStats();
+            emit statusUpdate(QString("Poster saved: %1 (%2 MP/s)").arg(baseFileName)
+                                  .arg(stats.getMegaPixelsPerSecond(), 0, 'f', 1));
+            Utils::scanMediaFile(fileName);
+        },
+        Qt::SingleShotConnection);
+
+    emit statusUpdate(QString("Saving %1x%2 poster").arg(posterSize.width()).arg(posterSize.height()));
+    thread->start();
+}
+
+void SpiralScene::saveVector(VectorFormat format)
+{
+    const bool pdf = (format == VECTOR_PDF);
+    const QString baseFileName = Utils::createPictureFileName("", pdf ? "pdf" : "svg");
+    const QString fileName = getNewPictureFilePath(baseFileName);
+
+    if (fileName.isEmpty())
+        return;
+
+    auto exporter = VectorExporter::create(pdf ? VectorExporter::Format::PDF : VectorExporter::Format::SVG);
+    const QRectF rect = mSceneRect.adjusted(-POSTER_MARGIN, -POSTER_MARGIN, POSTER_MARGIN, POSTER_MARGIN);
+
+    try {
+        exporter->open(fileName, rect, Qt::black);
+
+        for (const auto& [_, line] : mLines)
+        {
+            exporter->beginLine(line.mColor, line.mLineWidth);
+            line.mHistory.forEach([&exporter](const QPointF& p){ exporter->addPoint(p); });
+
+            for (std::size_t i = line.mHistory.empty() ? 0 : 1; i < line.mLinePoints.size(); ++i)
+                exporter->addPoint(line.mLinePoints[i]);
+
+            exporter->endLine();
+        }
+
+        exporter->close();
+    } catch (RuntimeException& e) {
+        emit message(e.msg());
+        return;
+    }
+
+    qDebug() << "Saved file:" << fileName << "points:" << exporter->getInputPointCount()
+             << "simplified:" << exporter->getOutputPointCount();
+    emit statusUpdate(QString("Saved: %1").arg(baseFileName));
+    Utils::scanMediaFile(fileName);
+}
+
+QString SpiralScene::getNewPictureFilePath(const QString& baseFileName)
+{
+    QString picPath;
+    try {
+        picPath = Utils::getPicturesPath();
+    } catch (RuntimeException& e) {
+        emit message(e.msg());
+        return {};
+    }
+
+    if (picPath.isEmpty())
+    {
+        emit message("Cannot save file.");
+        return {};
+    }
+
+    const QString fileName = picPath + "/" + baseFileName;
+    if (QFile::exists(fileName))
+    {
+        emit message(QString("Failed to create: %1").arg(fileName));
+        return {};
+    }
+
+    return fileName;
+}
+
+// The thumbnail is rendered on the CPU, so it does not depend on the window.
+// As the scaled window grab used before, the scene is scaled such that its
+// shortest side is the thumbnail size.
+void SpiralScene::saveConfig()
+{
+    const qreal scale = CFG_IMAGE_SIZE / std::min(width(), height());
+    const QRect cutRect(QPoint(0, 0), (size() * scale).toSize());
+    QImage img = renderImage(cutRect, scale);
+
+    SoftwareRasterizer rasterizer(img);
+    rasterizer.setTransform(scale, cutRect.topLeft());
+    renderCircles(rasterizer);
+
+    const QImage thumbnail = Utils::createThumbnail(img, size(), mSceneRect, CFG_IMAGE_SIZE);
+    SpiralConfig cfg(mEngine, mDefaultCircleRadius);
+
+    try {
+        cfg.save(thumbnail);
+        emit statusUpdate("Config saved");
+    } catch (RuntimeException& e) {
+        emit message(e.msg());
+    }
 }
 
 QObjectList SpiralScene::getConfigFileList()
 {
     mConfigFileList.clear();
-    SpiralConfig cfg(mCircles, mDefaultCircleRadius);
+    SpiralConfig cfg(mEngine, mDefaultCircleRadius);
 
     QObjectList l;
     try {
@@ -963,7 +1882,7 @@ QObjectList SpiralScene::getConfigFileList()
 
 void SpiralScene::loadConfig(const QString& fileName)
 {
-    SpiralConfig cfg(mCircles, mDefaultCircleRadius);
+    SpiralConfig cfg(mEngine, mDefaultCircleRadius);
 
     try {
         const CircleConfigList circleCfgList = cfg.load(fileName);
@@ -976,7 +1895,7 @@ void SpiralScene::loadConfig(const QString& fileName)
 
 void SpiralScene::deleteConfig(const QStringList& fileNameList)
 {
-    SpiralConfig cfg(mCircles, mDefaultCircleRadius);
+    SpiralConfig cfg(mEngine, mDefaultCircleRadius);
     cfg.remove(fileNameList);
 }
 
@@ -994,22 +1913,17 @@ QStringList SpiralScene::getCircleColorList() const
 
 QRectF SpiralScene::getMaxSceneRect() const
 {
-    Q_ASSERT(!mCircles.empty());
-    qreal halfSize = mCircles[0]->getRadius();
-
-    for (unsigned i = 1; i < mCircles.size(); ++i)
-        halfSize += mCircles[i]->getDiameter();
-
-    const QPointF& center = mCircles[0]->getCenter();
-    const qreal x = center.x() - halfSize;
-    const qreal y = center.y() - halfSize;
-
-    return QRectF(x, y, halfSize * 2, halfSize * 2) & boundingRect();
+    return mEngine.getMaxRect() & boundingRect();
 }
 
 std::unique_ptr<SceneGrabber> SpiralScene::createSceneGrabber(const QRectF& rect)
 {
-    return std::make_unique<SceneGrabber>(this, rect);
+    auto sceneGrabber = std::make_unique<SceneGrabber>(this, rect);
+    auto lineRenderState = std::make_shared<LineRenderState>();
+    sceneGrabber->setRenderers(
+        [this, lineRenderState](SoftwareRasterizer& rasterizer){ renderNewLinePoints(rasterizer, *lineRenderState); },
+        [this](SoftwareRasterizer& rasterizer){ renderCircles(rasterizer); });
+    return sceneGrabber;
 }
 
 bool SpiralScene::sendAppToBackground()
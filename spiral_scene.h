@@ -3,19 +3,29 @@
 #pragma once
 
 #include "circle.h"
+#include "flash_pool.h"
 #include "mutation_sequence.h"
 #include "player.h"
 #include "scene_grabber.h"
 #include "scoped_line.h"
 #include "spiral_config.h"
+#include "spiral_engine.h"
+#include "zoom_resampler.h"
 #include <QQuickItem>
 #include <QQuickWindow>
+#include <QSGGeometry>
+#include <QSGNode>
+#include <QThread>
+#include <QTimer>
+#include <map>
 #include <memory>
 #include <cstdint>
 #include <unordered_map>
 
 namespace SpiralFun {
 
+class SoftwareRasterizer;
+
 class SpiralScene : public QQuickItem, public ISequencePlayer
 {
     Q_OBJECT
@@ -26,6 +36,7 @@ class SpiralScene : public QQuickItem, public ISequencePlayer
     Q_PROPERTY(int MAX_ROTATIONS MEMBER MAX_ROTATIONS CONSTANT)
     Q_PROPERTY(int MAX_DRAW MEMBER MAX_DRAW CONSTANT)
     Q_PROPERTY(int CFG_IMAGE_SIZE MEMBER CFG_IMAGE_SIZE CONSTANT)
+    Q_PROPERTY(int POSTER_SIZE MEMBER POSTER_SIZE CONSTANT)
     Q_PROPERTY(int MIN_PLAYING_SPEED MEMBER MIN_PLAYING_SPEED CONSTANT)
     Q_PROPERTY(int MAX_PLAYING_SPEED MEMBER MAX_PLAYING_SPEED CONSTANT)
     Q_PROPERTY(int MIN_TONE_DISTANCE MEMBER MIN_TONE_DISTANCE CONSTANT)
@@ -35,6 +46,8 @@ class SpiralScene : public QQuickItem, public ISequencePlayer
     Q_PROPERTY(int currentCircleIndex READ getCurrentCircleIndex NOTIFY currentCircleIndexChanged)
     Q_PROPERTY(SpiralScene::PlayState playState READ getPlayState NOTIFY playStateChanged)
     Q_PROPERTY(qreal playAngle READ getPlayAngle NOTIFY playAngleChanged);
+    Q_PROPERTY(qreal playEndAngle READ getPlayEndAngle NOTIFY playAngleChanged);
+    Q_PROPERTY(qreal curveProgress READ getCurveProgress NOTIFY curveProgressChanged);
     Q_PROPERTY(int sequenceFrame READ getSequenceFrame NOTIFY sequenceFrameChanged)
     Q_PROPERTY(int sequenceLength READ getSequenceLength NOTIFY sequenceLengthChanged)
     Q_PROPERTY(SpiralScene::ShareMode shareMode READ getShareMode NOTIFY shareModeChanged)
@@ -42,6 +55,8 @@ class SpiralScene : public QQuickItem, public ISequencePlayer
     Q_PROPERTY(bool musicGeneration READ getMusicGeneration WRITE setMusicGeneration NOTIFY musicGenerationChanged)
     Q_PROPERTY(int playingSpeed READ getPlayingSpeed WRITE setPlayingSpeed NOTIFY playingSpeedChanged)
     Q_PROPERTY(int toneDistance READ getToneDistance WRITE setToneDistance NOTIFY toneDistanceChanged)
+    Q_PROPERTY(bool recurrenceStepping READ getRecurrenceStepping WRITE setRecurrenceStepping NOTIFY recurrenceSteppingChanged)
+    Q_PROPERTY(SpiralScene::LineRenderer lineRenderer READ getLineRenderer WRITE setLineRenderer NOTIFY lineRendererChanged)
     QML_ELEMENT
 
 public:
@@ -53,18 +68,32 @@ public:
     enum ShareMode { SHARE_NONE, SHARE_PIC, SHARE_GIF, SHARE_VIDEO };
     Q_ENUM(ShareMode)
 
+    enum VectorFormat { VECTOR_SVG, VECTOR_PDF };
+    Q_ENUM(VectorFormat)
+
+    // NODES: a geometry node per line, BATCHED: a vertex colored node for all lines,
+    // TRIANGLES: lines tessellated into a vertex colored triangle strip for all lines.
+    enum LineRenderer { LINE_RENDERER_NODES, LINE_RENDERER_BATCHED, LINE_RENDERER_TRIANGLES };
+    Q_ENUM(LineRenderer)
+
     struct Stats
     {
         Player::Stats mPlayerStats;
         uint32_t mLineSegmentCount = 0;
-        uint32_t mLineCount = 0;
+        uint32_t mNodeCount = 0;
+        uint64_t mVertexCount = 0;
+        uint32_t mLineDrawCalls = 0;
         uint32_t mLinePointsSum = 0;
+        uint64_t mSampleCount = 0;
     };
 
     explicit SpiralScene(QQuickItem *parent = nullptr);
+    ~SpiralScene();
 
     void setupCircles(const SpiralFun::CircleConfigList& config = DEFAULT_CONFIG);
     int getNumCircles() const { return mCircles.size(); }
+    SpiralEngine& getEngine() { return mEngine; }
+    const SpiralEngine& getEngine() const { return mEngine; }
     SpiralFun::Circle* getCurrentCircle() const;
     int getCurrentCircleIndex() const { return mCurrentIndex; }
     PlayState getPlayState() const { return mPlayState; }
@@ -73,10 +102,16 @@ public:
     void setMusicGeneration(bool musicGeneration);
     int getPlayingSpeed() const { return mPlayingSpeed; }
     void setPlayingSpeed(int playingSpeed);
+    bool getRecurrenceStepping() const { return mRecurrenceStepping; }
+    void setRecurrenceStepping(bool recurrenceStepping);
+    LineRenderer getLineRenderer() const { return mLineRenderer; }
+    void setLineRenderer(LineRenderer lineRenderer);
     int getToneDistance() const { return mToneDistance; }
     void setToneDistance(int toneDistance);
     int getMaxDiameter() const override { return MAX_DIAMETER; }
     qreal getPlayAngle() const { return mPlayer ? mPlayer->getAngle() : 0.0; }
+    qreal getPlayEndAngle() const { return mPlayer ? mPlayer->getEndAngle() : M_PI * 2; }
+    qreal getCurveProgress() const { return mCurveProgress; }
     int getSequenceFrame() const { return mMutationSequence ? mMutationSequence->getCurrentSequenceFrame() : 0; }
     int getSequenceLength() const { return mMutationSequence ? mMutationSequence->getTotalSequenceLength() : 0; }
     void setNumCircles(int numCircles);
@@ -88,6 +123,17 @@ public:
     QRectF getBoundingRect() const override { return boundingRect(); }
     std::unique_ptr<SceneGrabber> createSceneGrabber(const QRectF& rect) override;
 
+    // Redraw the circle outlines at the next frame.
+    void updateCircleOutlines();
+
+    // Highlight a played note.
+    void addFlash(const QPointF& center, const QColor& color);
+
+    // Draw the lines on the CPU. renderImage shows cutRect of the scene scaled by
+    // scale in pixels, on the scene background.
+    void renderLines(SoftwareRasterizer& rasterizer) const;
+    QImage renderImage(const QRect& cutRect, qreal scale = 1.0) const;
+
     Q_INVOKABLE void init();
     Q_INVOKABLE void setupExample(const QString& example);
     Q_INVOKABLE void circleUp();
@@ -102,6 +148,8 @@ public:
     Q_INVOKABLE void stop();
     Q_INVOKABLE bool saveImage(const QRectF cutRect = {}, const QString subDir = "", const QString& baseNameSuffix = "",
                                const ISequencePlayer::SavedCallback& savedCallback = nullptr) override;
+    Q_INVOKABLE void savePoster(int size);
+    Q_INVOKABLE void saveVector(VectorFormat format);
     Q_INVOKABLE void saveConfig();
     Q_INVOKABLE void share();
     Q_INVOKABLE QObjectList getConfigFileList();
@@ -118,6 +166,7 @@ signals:
     void numCirclesChanged();
     void playStateChanged();
     void playAngleChanged();
+    void curveProgressChanged();
     void sequenceFrameChanged();
     void sequenceLengthChanged();
     void shareModeChanged();
@@ -125,19 +174,38 @@ signals:
     void musicGenerationChanged();
     void playingSpeedChanged();
     void toneDistanceChanged();
+    void recurrenceSteppingChanged();
+    void lineRendererChanged();
     void message(const QString message);
     void statusUpdate(const QString message);
     void sequenceFramePlayed();
 
 protected:
     QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) override;
+    void mousePressEvent(QMouseEvent* event) override;
     void touchEvent(QTouchEvent* event) override;
 
 private:
+    // Points of each line drawn by a scene grabber so far. The lines are drawn
+    // again when lines were added or removed since.
+    struct LineRenderState
+    {
+        unsigned mLineGeneration = 0;
+        std::unordered_map<const QObject*, std::size_t> mDrawnPoints;
+    };
+
+    struct LineBatch
+    {
+        QSGGeometryNode* mNode = nullptr;
+        unsigned mVertexCount = 0;
+        LineVertexColorMaterial* mMaterial = nullptr; // owned by the first node
+    };
+
     void calcDefaultRadiusSize();
     void handleWindowSizeChanged();
     SpiralFun::Circle* addCircle(qreal radius);
     std::optional<unsigned> findCircle(const Circle* circle);
+    std::optional<unsigned> findCircleAt(const QPointF& p) const;
     void handleDiameterChange(Circle* circle, int oldDiameter);
     void moveCircles(unsigned index, qreal yShift);
     void setCurrentCircleFocus(bool focus);
@@ -151,8 +219,27 @@ private:
     void handleReceivedAndroidIntent(const QString& uri);
     void setPlayState(PlayState state);
     void setShareMode(ShareMode shareMode);
-    QSGNode* createLineNode(Line& line);
+    QString getNewPictureFilePath(const QString& baseFileName);
+    void rebuildLineNodes(QSGNode* sceneRoot);
+    void addLinePoints(QSGNode* sceneRoot, Line& line, const std::vector<QPointF>& points);
+    void addLineNodePoints(QSGNode* sceneRoot, Line& line, const std::vector<QPointF>& points);
+    void createLineNode(Line& line, const QPointF& startPoint);
+    void addBatchedLinePoints(QSGNode* sceneRoot, const Line& line, const std::vector<QPointF>& points);
+    void addTessellatedLinePoints(QSGNode* sceneRoot, Line& line, const std::vector<QPointF>& points);
+    void createBatchRoot(QSGNode* sceneRoot);
+    void fillBatchTail(LineBatch& batch);
+    void appendBatchVertex(LineBatch& batch, int lineWidth, const QSGGeometry::ColoredPoint2D& vertex);
+    void createBatchNode(LineBatch& batch, int lineWidth);
+    void resampleZoom();
+    void clearZoomDetail();
+    void updateZoomNodes(QSGNode* sceneRoot);
+    void updateCircleNode(QSGNode* sceneRoot);
+    void updateFlashNode(QSGNode* sceneRoot);
+    void updateLineDrawCalls();
+    void renderNewLinePoints(SoftwareRasterizer& rasterizer, LineRenderState& state) const;
+    void renderCircles(SoftwareRasterizer& rasterizer) const;
     void updateSceneRect(const QPointF& p);
+    std::size_t getLineHistoryMemoryUsage() const;
     void doPlay(std::unique_ptr<Recorder> recorder);
     void shareImage();
     void shareMedia();
@@ -160,24 +247,52 @@ private:
     void shareVideo();
 
     std::unordered_map<QObject*, Line> mLines;
+    unsigned mLineGeneration = 0;
     bool mDoRender = true;
     bool mClearScene = false;
+    bool mRebuildLines = false;
+    LineRenderer mLineRenderer = LINE_RENDERER_TRIANGLES;
+    QSGOpacityNode* mLinesNode = nullptr;
+    QSGNode* mBatchRoot = nullptr;
+    std::map<int, LineBatch> mLineBatches; // line width -> batch, 0 for triangles
+    std::vector<QPointF> mStripVertices;
+    QSGGeometryNode* mCircleNode = nullptr;
+    std::vector<QSGGeometry::ColoredPoint2D> mCircleVertices;
+    bool mUpdateCircles = true;
+    FlashPool mFlashPool;
+    QTimer mFlashTimer;
+    QSGGeometryNode* mFlashNode = nullptr;
+    bool mUpdateFlashes = false;
     QRectF mSceneRect;
     Stats mStats;
+    SpiralEngine mEngine;
     CircleList mCircles;
     qreal mDefaultCircleRadius = 10.0;
     unsigned mCurrentIndex = 0;
     std::unique_ptr<Player> mPlayer;
+    qreal mCurveProgress = 0.0;
     PlayState mPlayState = NOT_PLAYING;
     qreal mScaleFactor = 1.0;
+
+    // Lines of the visible part of the spiral calculated for the zoom scale.
+    // They replace the magnified lines when ready.
+    QTimer mZoomTimer;
+    std::unique_ptr<QThread> mZoomThread;
+    std::shared_ptr<ZoomResampler> mZoomDetail;
+    unsigned mZoomGeneration = 0;
+    bool mZoomPending = false;
+    bool mZoomDetailChanged = false;
+    QSGNode* mZoomRoot = nullptr;
     std::vector<std::unique_ptr<QObject>> mConfigFileList;
     bool mSharingInProgress = false;
     ShareMode mShareMode = SHARE_NONE;
     QString mShareMediaUri;
     std::unique_ptr<SceneGrabber> mSceneGrabber;
+    std::unique_ptr<QThread> mPosterThread;
     std::unique_ptr<MutationSequence> mMutationSequence;
     bool mMusicGeneration = false;
     int mPlayingSpeed = MAX_PLAYING_SPEED;
+    bool mRecurrenceStepping = false;
     int mToneDistance = 25;
     bool mInitialized = false;
 
@@ -186,6 +301,7 @@ private:
     static constexpr int MAX_ROTATIONS = SpiralConfig::MAX_SPEED;
     static constexpr int MAX_DRAW = Circle::MAX_DRAW;
     static constexpr int CFG_IMAGE_SIZE = 150;
+    static constexpr int POSTER_SIZE = 16384;
     static constexpr int MIN_PLAYING_SPEED = 1;
     static constexpr int MAX_PLAYING_SPEED = 50;
     static constexpr int MIN_TONE_DISTANCE = 10;
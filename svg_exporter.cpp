@@ -0,0 +1,104 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "svg_exporter.h"
+#include "exception.h"
+
+namespace SpiralFun {
+
+namespace {
+// Coordinates are written with 2 decimals, the rounding error is far below
+// the simplification tolerance.
+constexpr int COORDINATE_PRECISION = 2;
+
+constexpr unsigned POINTS_PER_TEXT_LINE = 8;
+}
+
+SvgExporter::~SvgExporter()
+{
+    // A file that is still open was not completed.
+    if (mFile.isOpen())
+    {
+        mFile.close();
+        mFile.remove();
+    }
+}
+
+void SvgExporter::open(const QString& fileName, const QRectF& sceneRect, const QColor& background)
+{
+    Q_ASSERT(!mFile.isOpen());
+    mFile.setFileName(fileName);
+
+    if (!mFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        throw RuntimeException(QString("Failed to create: %1").arg(fileName));
+
+    mStream.setDevice(&mFile);
+    mStream.setRealNumberNotation(QTextStream::FixedNotation);
+    mStream.setRealNumberPrecision(COORDINATE_PRECISION);
+
+    mStream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << sceneRect.width()
+            << "\" height=\"" << sceneRect.height() << "\" viewBox=\"" << sceneRect.x() << ' '
+            << sceneRect.y() << ' ' << sceneRect.width() << ' ' << sceneRect.height() << "\">\n"
+            << "<rect x=\"" << sceneRect.x() << "\" y=\"" << sceneRect.y() << "\" width=\""
+            << sceneRect.width() << "\" height=\"" << sceneRect.height() << "\" fill=\""
+            << background.name() << "\"/>\n";
+
+    checkStatus();
+}
+
+void SvgExporter::close()
+{
+    mStream << "</svg>\n";
+    mStream.flush();
+    checkStatus();
+    mFile.close();
+
+    if (mFile.error() != QFileDevice::NoError)
+        throw RuntimeException(QString("Failed to write: %1").arg(mFile.fileName()));
+}
+
+void SvgExporter::writeLineStart(const QColor& color, qreal width)
+{
+    // The path is started with its first point, a line without points is not written.
+    mLineColor = color;
+    mLineWidth = width;
+    mPathStarted = false;
+    mPathPointCount = 0;
+}
+
+void SvgExporter::writeLinePoints(const std::vector<QPointF>& points)
+{
+    if (!mPathStarted)
+    {
+        mStream << "<path fill=\"none\" stroke=\"" << mLineColor.name() << "\" stroke-opacity=\""
+                << mLineColor.alphaF() << "\" stroke-width=\"" << mLineWidth
+                << "\" stroke-linecap=\"round\" stroke-linejoin=\"round\" d=\"M";
+        mPathStarted = true;
+    }
+
+    // Coordinates after the first pair are implicit line-to commands.
+    for (const QPointF& p : points)
+    {
+        mStream << (mPathPointCount % POINTS_PER_TEXT_LINE == 0 && mPathPointCount > 0 ? '\n' : ' ')
+                << p.x() << ' ' << p.y();
+        ++mPathPointCount;
+    }
+
+    checkStatus();
+}
+
+void SvgExporter::writeLineEnd()
+{
+    if (mPathStarted)
+        mStream << "\"/>\n";
+
+    mPathStarted = false;
+}
+
+void SvgExporter::checkStatus()
+{
+    if (mStream.status() != QTextStream::Ok)
+        throw RuntimeException(QString("Failed to write: %1").arg(mFile.fileName()));
+}
+
+}
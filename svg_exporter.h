@@ -0,0 +1,35 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "vector_exporter.h"
+#include <QFile>
+#include <QTextStream>
+
+namespace SpiralFun {
+
+// Each line is a path with round caps and joins.
+class SvgExporter : public VectorExporter
+{
+public:
+    ~SvgExporter();
+
+    void open(const QString& fileName, const QRectF& sceneRect, const QColor& background) override;
+    void close() override;
+
+protected:
+    void writeLineStart(const QColor& color, qreal width) override;
+    void writeLinePoints(const std::vector<QPointF>& points) override;
+    void writeLineEnd() override;
+
+private:
+    void checkStatus();
+
+    QFile mFile;
+    QTextStream mStream;
+    QColor mLineColor;
+    qreal mLineWidth = 1.0;
+    bool mPathStarted = false;
+    unsigned mPathPointCount = 0;
+};
+
+}
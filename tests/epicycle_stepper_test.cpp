@@ -0,0 +1,111 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "epicycle_evaluator.h"
+#include "epicycle_stepper.h"
+#include <QLineF>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace SpiralFun;
+
+namespace {
+
+// Stepped centers may differ this much (pixels) from the exact centers. This is
+// far below the 0.25 pixel error allowed for drawing the curves.
+constexpr qreal TOLERANCE = 1e-6;
+
+// Steps over multiple resync periods, such that drift would accumulate past a
+// resync if the resync did not restore the exact vectors.
+constexpr unsigned RESYNC_PERIODS = 8;
+
+// Play step of 0.05 degrees as in Player.
+const qreal PLAY_STEP_ANGLE = qDegreesToRadians(0.05);
+
+struct TestCase
+{
+    const char* mName;
+    std::vector<qreal> mRadii;
+    std::vector<int> mSpeeds;
+};
+
+// Place the circles on a line from the center of the first circle, each
+// touching its parent inside. Speed[0] is the speed of the fixed first circle.
+std::vector<QPointF> createCenters(const std::vector<qreal>& radii)
+{
+    std::vector<QPointF> centers;
+    QPointF center(500, 500);
+    centers.push_back(center);
+
+    for (unsigned i = 1; i < radii.size(); ++i)
+    {
+        const qreal a = qDegreesToRadians(37.0 * i);
+        center += QPointF(qCos(a), qSin(a)) * (radii[i - 1] - radii[i]);
+        centers.push_back(center);
+    }
+
+    return centers;
+}
+
+qreal calcSubStepAngle(const EpicycleEvaluator& evaluator)
+{
+    // Same sub step calculation as SpiralEngine with a maximum error of 0.25 pixel.
+    const qreal maxAcceleration = evaluator.getMaxAcceleration(evaluator.size() - 1);
+    const int subSteps = std::max(1, int(std::ceil(PLAY_STEP_ANGLE * std::sqrt(maxAcceleration / 2.0))));
+    return PLAY_STEP_ANGLE / subSteps;
+}
+
+bool runTest(const TestCase& test)
+{
+    EpicycleEvaluator evaluator;
+    evaluator.init(createCenters(test.mRadii), test.mSpeeds);
+    const qreal stepAngle = calcSubStepAngle(evaluator);
+
+    EpicycleStepper stepper;
+    stepper.init(evaluator, 0.0, stepAngle);
+
+    std::vector<QPointF> stepped;
+    std::vector<QPointF> exact;
+    qreal maxDrift = 0.0;
+
+    for (unsigned n = 1; n <= RESYNC_PERIODS * EpicycleStepper::RESYNC_STEPS; ++n)
+    {
+        stepper.step(stepped);
+        evaluator.evaluate(n * stepAngle, exact);
+
+        for (unsigned i = 0; i < exact.size(); ++i)
+        {
+            const qreal drift = QLineF(stepped[i], exact[i]).length();
+            maxDrift = std::max(maxDrift, drift);
+
+            if (drift > TOLERANCE)
+            {
+                std::printf("FAIL %s: step %u circle %u drift %g > %g\n", test.mName, n, i, drift, TOLERANCE);
+                return false;
+            }
+        }
+    }
+
+    std::printf("PASS %s: max drift %g\n", test.mName, maxDrift);
+    return true;
+}
+
+}
+
+int main()
+{
+    const std::vector<TestCase> tests = {
+        { "slow", { 400, 200, 100 }, { 0, 1, -3 } },
+        { "mixed", { 450, 300, 170, 90, 40 }, { 0, 7, -11, 13, -17 } },
+        { "fast", { 450, 240, 120, 60 }, { 0, 501, -1237, 2999 } },
+        { "max speed", { 480, 400, 330, 270, 220, 180, 140, 100, 60, 30 },
+          { 0, 9999, 9999, -9999, 9999, 9999, -9999, 9999, 9999, 9999 } },
+    };
+
+    bool passed = true;
+
+    for (const auto& test : tests)
+        passed = runTest(test) && passed;
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
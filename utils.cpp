@@ -130,9 +130,9 @@ QString createDateTimeName()
     return QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
 }
 
-QString createPictureFileName(const QString& baseNameSuffix)
+QString createPictureFileName(const QString& baseNameSuffix, const QString& extension)
 {
-    return QString("IMG_%1%2.jpg").arg(createDateTimeName(), baseNameSuffix);
+    return QString("IMG_%1%2.%3").arg(createDateTimeName(), baseNameSuffix, extension);
 }
 
 void scanMediaFile(const QString& fileName)
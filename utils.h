@@ -11,7 +11,7 @@ QString createDateTimeName();
 QString getPicturesPath(const QString& subDir = "");
 QString getPublicSpiralConfigPath();
 QString getSpiralConfigPath();
-QString createPictureFileName(const QString& baseNameSuffix = "");
+QString createPictureFileName(const QString& baseNameSuffix = "", const QString& extension = "jpg");
 void scanMediaFile(const QString& fileName);
 void shareMedia(const QString& contentUri, const QString& configAppUri, const QString& mimeType);
 void handlePendingIntent();
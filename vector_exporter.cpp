@@ -0,0 +1,61 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "vector_exporter.h"
+#include "pdf_exporter.h"
+#include "svg_exporter.h"
+
+namespace SpiralFun {
+
+namespace {
+// Number of simplified points passed to the file at once
+constexpr std::size_t POINT_BATCH_SIZE = 1024;
+}
+
+std::unique_ptr<VectorExporter> VectorExporter::create(Format format)
+{
+    switch (format)
+    {
+    case Format::SVG:
+        return std::make_unique<SvgExporter>();
+    case Format::PDF:
+        return std::make_unique<PdfExporter>();
+    }
+
+    Q_ASSERT(false);
+    return nullptr;
+}
+
+void VectorExporter::beginLine(const QColor& color, qreal width)
+{
+    mSimplifier.reset();
+    mPoints.clear();
+    writeLineStart(color, width);
+}
+
+void VectorExporter::addPoint(const QPointF& p)
+{
+    ++mInputPointCount;
+    mSimplifier.add(p, mPoints);
+
+    if (mPoints.size() >= POINT_BATCH_SIZE)
+        flushPoints();
+}
+
+void VectorExporter::endLine()
+{
+    mSimplifier.finish(mPoints);
+    flushPoints();
+    writeLineEnd();
+}
+
+void VectorExporter::flushPoints()
+{
+    if (mPoints.empty())
+        return;
+
+    writeLinePoints(mPoints);
+    mOutputPointCount += mPoints.size();
+    mPoints.clear();
+}
+
+}
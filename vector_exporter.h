@@ -0,0 +1,61 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "polyline_simplifier.h"
+#include <QColor>
+#include <QRectF>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SpiralFun {
+
+// Writes lines as vector paths, one path per line. Points are streamed in and
+// simplified within the tolerance. The simplified points are passed on to the
+// file in batches, such that a file is never built in memory as a whole.
+// Errors throw RuntimeException.
+class VectorExporter
+{
+public:
+    enum class Format { SVG, PDF };
+
+    // Tolerance in scene units
+    static constexpr qreal DEFAULT_TOLERANCE = 0.05;
+
+    static std::unique_ptr<VectorExporter> create(Format format);
+
+    virtual ~VectorExporter() = default;
+
+    void setTolerance(qreal tolerance) { mSimplifier.setTolerance(tolerance); }
+
+    // The document shows sceneRect of the scene on the background color.
+    virtual void open(const QString& fileName, const QRectF& sceneRect, const QColor& background) = 0;
+
+    void beginLine(const QColor& color, qreal width);
+    void addPoint(const QPointF& p);
+    void endLine();
+
+    virtual void close() = 0;
+
+    uint64_t getInputPointCount() const { return mInputPointCount; }
+    uint64_t getOutputPointCount() const { return mOutputPointCount; }
+
+protected:
+    virtual void writeLineStart(const QColor& color, qreal width) = 0;
+
+    // Next points of the line being written.
+    virtual void writeLinePoints(const std::vector<QPointF>& points) = 0;
+
+    virtual void writeLineEnd() = 0;
+
+private:
+    void flushPoints();
+
+    PolylineSimplifier mSimplifier{DEFAULT_TOLERANCE};
+    std::vector<QPointF> mPoints;
+    uint64_t mInputPointCount = 0;
+    uint64_t mOutputPointCount = 0;
+};
+
+}
@@ -21,6 +21,9 @@ bool VideoEncoder::open(const QString &fileName, int width, int height, int fps,
                                                            jsFile.object<jstring>(),
                                                            (jint)width, (jint)height, (jint)fps,
                                                            (jint)fps * bitsPerFrame);
+
+    QJniEnvironment env;
+    mFrameArray = QJniObject::fromLocalRef(env->NewByteArray(width * height * 4));
     return (bool)result;
 #else
     Q_UNUSED(fileName);
@@ -42,22 +45,27 @@ bool VideoEncoder::close()
         mEncoder = nullptr;
     }
 
+    mFrameArray = QJniObject();
+
     return true;
 #else
     throw RuntimeException("Video encoding not supported!");
 #endif
 }
 
-bool VideoEncoder::push(const QImage& frame, int, int)
+bool VideoEncoder::push(QImage& frame, int, int)
 {
 #if defined(Q_OS_ANDROID)
     Q_ASSERT(mWidth == frame.width());
     Q_ASSERT(mHeight == frame.height());
     QJniEnvironment env;
-    const int size = frame.width() * frame.height() * 4;
-    auto jsFrame = env->NewByteArray(size);
-    const uint8_t* frameBits = frame.constBits();
-    env->SetByteArrayRegion(jsFrame, 0, size, (jbyte*)frameBits);
+    auto jsFrame = mFrameArray.object<jbyteArray>();
+    const int rowSize = frame.width() * 4;
+
+    // The rows of the frame may have a larger stride than the rows in the array.
+    for (int y = 0; y < frame.height(); ++y)
+        env->SetByteArrayRegion(jsFrame, y * rowSize, rowSize, (const jbyte*)frame.constScanLine(y));
+
     auto added = mEncoder->callMethod<jboolean>("addFrame", "([B)Z", jsFrame);
     return (bool)added;
 #else
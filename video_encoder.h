@@ -15,13 +15,16 @@ class VideoEncoder : public IVideoEncoder
 public:
     bool open(const QString &fileName, int width, int height, int fps, int bitsPerFrame) override;
     bool close() override;
-    bool push(const QImage& frame, int x = 0, int y = 0) override;
+    bool push(QImage& frame, int x = 0, int y = 0) override;
     QString getFileExtension() const override { return "mp4"; }
     bool canEncodePartialFrame() const override { return false; }
 
 private:
 #if defined(Q_OS_ANDROID)
     std::unique_ptr<QJniObject> mEncoder;
+
+    // Java byte array for the frame pixels, reused for all frames.
+    QJniObject mFrameArray;
 #endif
     int mWidth = 0;
     int mHeight = 0;
@@ -13,7 +13,11 @@ public:
 
     virtual bool open(const QString& fileName, int width, int height, int fps, int bitsPerFrame) = 0;
     virtual bool close() = 0;
-    virtual bool push(const QImage& frame, int x = 0, int y = 0) = 0;
+
+    // The frame may be a view on a larger image, i.e. the bytes per line can be
+    // more than the width of the frame. Frames are pushed from a worker thread.
+    // The frame is not used after the push, so the encoder may write in it.
+    virtual bool push(QImage& frame, int x = 0, int y = 0) = 0;
     virtual QString getFileExtension() const = 0;
     virtual bool canEncodePartialFrame() const = 0;
 };
@@ -0,0 +1,84 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#include "zoom_resampler.h"
+#include "line_tessellator.h"
+#include "spiral_engine.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtMath>
+
+namespace SpiralFun {
+
+namespace {
+// Angle over which the positions of a fast pen are calculated in one batch.
+constexpr qreal BATCH_ANGLE = M_PI / 1800;
+}
+
+ZoomResampler::ZoomResampler(const QRectF& visibleRect, qreal scale, qreal endAngle) :
+    mVisibleRect(visibleRect),
+    mScale(scale),
+    mEndAngle(endAngle)
+{
+    Q_ASSERT(scale > 0.0);
+}
+
+void ZoomResampler::addLine(const CurveSampler& sampler, const QColor& color, qreal width)
+{
+    mCurves.push_back({ sampler, width });
+    mLines.push_back({ color, {} });
+}
+
+void ZoomResampler::resample()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (std::size_t i = 0; i < mCurves.size(); ++i)
+        resampleLine(mCurves[i], mLines[i]);
+
+    mStats.mMilliseconds = timer.elapsed();
+    qDebug() << "Zoom resampled, scale:" << mScale << "ranges:" << mStats.mRangeCount
+             << "samples:" << mStats.mSampleCount << "time:" << mStats.mMilliseconds << "ms";
+}
+
+void ZoomResampler::resampleLine(const Curve& curve, Line& line)
+{
+    // A pixel on screen in scene units.
+    const qreal pixel = 1.0 / mScale;
+    const qreal width = curve.mWidth * pixel;
+
+    // A line just outside the visible rect still covers pixels inside it.
+    const qreal margin = width / 2.0 + pixel;
+    const QRectF rect = mVisibleRect.adjusted(-margin, -margin, margin, margin);
+    const auto ranges = curve.mSampler.getAngleRangesInRect(rect, 0.0, mEndAngle, pixel);
+
+    LineTessellator tessellator(width);
+    std::vector<QPointF> points;
+    std::vector<QPointF> strip;
+
+    for (const auto& [fromAngle, toAngle] : ranges)
+    {
+        curve.mSampler.sample(fromAngle, 0.0, 1, points);
+        mStats.mSampleCount += 1 + SpiralEngine::sampleRange(curve.mSampler, fromAngle, toAngle, BATCH_ANGLE,
+                                                             SpiralEngine::MAX_PIXEL_ERROR * pixel, points);
+
+        strip.clear();
+        tessellator.reset();
+        tessellator.append(points.data(), points.data() + points.size(), strip);
+
+        if (strip.empty())
+            continue;
+
+        if (!line.mStrip.empty())
+        {
+            line.mStrip.push_back(line.mStrip.back());
+            line.mStrip.push_back(strip.front());
+        }
+
+        line.mStrip.insert(line.mStrip.end(), strip.begin(), strip.end());
+    }
+
+    mStats.mRangeCount += ranges.size();
+}
+
+}
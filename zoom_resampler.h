@@ -0,0 +1,68 @@
+// Copyright (C) 2026 Michel de Boer
+// License: GPLv3
+#pragma once
+#include "curve_sampler.h"
+#include <QColor>
+#include <QRectF>
+#include <cstdint>
+#include <vector>
+
+namespace SpiralFun {
+
+// Calculates the visible part of finished curves again for a zoom scale, such
+// that a zoomed in curve has the smoothness and line width of an unzoomed curve.
+// The pen positions are evaluated directly for the angle ranges in which the
+// pen is visible. The cost depends on the visible length of the curves, not on
+// their total length.
+//
+// The samplers are copied, such that resample can run in the background while
+// the engine is used for something else.
+class ZoomResampler
+{
+public:
+    struct Line
+    {
+        QColor mColor;
+
+        // Triangle strip of the visible parts of the line, joined by degenerate triangles.
+        std::vector<QPointF> mStrip;
+    };
+
+    struct Stats
+    {
+        uint64_t mSampleCount = 0;
+        unsigned mRangeCount = 0;
+        qint64 mMilliseconds = 0;
+    };
+
+    // visibleRect in scene units, scale in pixels per scene unit. The curves
+    // are calculated from angle 0 to endAngle.
+    ZoomResampler(const QRectF& visibleRect, qreal scale, qreal endAngle);
+
+    // Line width in pixels.
+    void addLine(const CurveSampler& sampler, const QColor& color, qreal width);
+
+    void resample();
+
+    qreal getScale() const { return mScale; }
+    const std::vector<Line>& getLines() const { return mLines; }
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Curve
+    {
+        CurveSampler mSampler;
+        qreal mWidth;
+    };
+
+    void resampleLine(const Curve& curve, Line& line);
+
+    QRectF mVisibleRect;
+    qreal mScale;
+    qreal mEndAngle;
+    std::vector<Curve> mCurves;
+    std::vector<Line> mLines;
+    Stats mStats;
+};
+
+}